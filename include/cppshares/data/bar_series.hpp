@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "market_data.hpp"
+
+namespace cppshares::data {
+
+inline constexpr size_t BAR_COLUMN_ALIGNMENT = 64;
+
+// 按缓存行对齐分配的分配器，保证各列首地址可直接用于向量化加载
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>& /*other*/) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(
+            ::operator new(n * sizeof(T), std::align_val_t{BAR_COLUMN_ALIGNMENT}));
+    }
+    void deallocate(T* ptr, size_t /*n*/) noexcept {
+        ::operator delete(ptr, std::align_val_t{BAR_COLUMN_ALIGNMENT});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// 单个证券的K线序列，按列存储：时间戳与各价格、成交量列分别连续存放
+// 整个序列只保存一个 symbol_id，各列以 span 形式交给 utils/math.hpp 中的指标计算
+class BarSeries {
+public:
+    explicit BarSeries(SymbolId symbol_id = INVALID_SYMBOL_ID) : symbol_id_(symbol_id) {}
+
+    // 由逐根K线构造，证券取自第一根；各K线证券不一致时抛出 std::invalid_argument
+    static BarSeries from_bars(std::span<const OHLCV> bars);
+    std::vector<OHLCV> to_bars() const;
+
+    // 追加一根K线，证券与序列不一致时抛出 std::invalid_argument
+    void push_back(const OHLCV& bar);
+    void reserve(size_t capacity);
+    void clear();
+
+    OHLCV operator[](size_t index) const;
+    size_t size() const { return close_.size(); }
+    bool empty() const { return close_.empty(); }
+
+    SymbolId symbol_id() const { return symbol_id_; }
+    const std::string& symbol_name() const {
+        return utils::SymbolRegistry::global().name(symbol_id_);
+    }
+
+    std::chrono::system_clock::time_point timestamp(size_t index) const {
+        return std::chrono::system_clock::time_point(
+            std::chrono::microseconds(timestamp_us_[index]));
+    }
+
+    // 各列视图，在下一次追加或清空前有效
+    std::span<const int64_t> timestamps_us() const { return timestamp_us_; }  // unix 微秒
+    std::span<const double> open() const { return open_; }
+    std::span<const double> high() const { return high_; }
+    std::span<const double> low() const { return low_; }
+    std::span<const double> close() const { return close_; }
+    std::span<const uint64_t> volume() const { return volume_; }
+    std::span<const double> amount() const { return amount_; }
+
+private:
+    SymbolId symbol_id_;
+    AlignedVector<int64_t> timestamp_us_;
+    AlignedVector<double> open_;
+    AlignedVector<double> high_;
+    AlignedVector<double> low_;
+    AlignedVector<double> close_;
+    AlignedVector<uint64_t> volume_;
+    AlignedVector<double> amount_;
+};
+
+}  // namespace cppshares::data
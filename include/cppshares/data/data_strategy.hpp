@@ -1,11 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <future>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 #include "data_types.hpp"
@@ -32,6 +39,246 @@ struct ProviderHealth {
     int64_t avg_response_time_ms = 0;
 };
 
+// 无锁延迟直方图（毫秒），用于估计提供者的延迟分位数
+class LatencyHistogram {
+public:
+    void record(int64_t latency_ms);
+
+    // 返回分位数所在桶的上界（毫秒），没有样本时返回 nullopt
+    std::optional<int64_t> percentile(double p) const;
+
+    uint64_t sample_count() const;
+
+private:
+    static constexpr std::array<int64_t, 24> BUCKET_BOUNDS_MS = {
+        1,   2,   4,   6,   8,   10,   15,   20,   30,   40,   50,   75,
+        100, 150, 200, 300, 400, 500, 750, 1000, 1500, 2000, 3000, 5000};
+    // 样本数达到该值时所有桶减半，使分位数跟随近期延迟变化
+    static constexpr uint64_t DECAY_THRESHOLD = 1024;
+
+    std::array<std::atomic<uint64_t>, BUCKET_BOUNDS_MS.size() + 1> buckets_{};
+    std::atomic<uint64_t> samples_{0};
+};
+
+// 无锁令牌桶（GCRA实现，只维护一个理论到达时间原子量）
+class TokenBucket {
+public:
+    // requests_per_minute <= 0 表示不限流；burst_window 内的配额可以突发使用
+    void configure(int requests_per_minute, std::chrono::milliseconds burst_window);
+
+    // 非阻塞获取一个令牌，桶空时立即返回 false
+    bool try_acquire();
+
+private:
+    std::atomic<int64_t> interval_ns_{0};
+    std::atomic<int64_t> burst_tolerance_ns_{0};
+    std::atomic<int64_t> theoretical_arrival_ns_{0};
+};
+
+// 合并请求的键：同一数据类型、证券、周期与条数的请求视为相同
+struct RequestKey {
+    DataType type = DataType::REALTIME_QUOTE;
+    Symbol symbol;
+    KlinePeriod period = KlinePeriod::DAY_1;
+    int limit = 0;
+
+    bool operator==(const RequestKey& other) const = default;
+};
+
+// 类型、周期与条数拼成一个 64 位字，与证券的打包键依次经 splitmix64 混合
+struct RequestKeyHash {
+    size_t operator()(const RequestKey& key) const {
+        uint64_t fields = static_cast<uint64_t>(key.type) << 40 |
+                          static_cast<uint64_t>(key.period) << 32 |
+                          static_cast<uint32_t>(key.limit);
+        return static_cast<size_t>(mix64(mix64(key.symbol.key()) ^ fields));
+    }
+};
+
+// 单飞（single-flight）：相同键的并发调用只执行一次，其余调用等待并共享同一结果
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class SingleFlight {
+public:
+    template <typename Fn>
+    Value run(const Key& key, Fn&& fn) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (auto it = in_flight_.find(key); it != in_flight_.end()) {
+            auto future = it->second;
+            lock.unlock();
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            return future.get();
+        }
+
+        std::promise<Value> promise;
+        in_flight_.emplace(key, promise.get_future().share());
+        lock.unlock();
+
+        // 先移出表再发布结果：之后到达的调用会发起新的请求，而不是拿到已完成的旧结果
+        try {
+            Value value = fn();
+            forget(key);
+            promise.set_value(value);
+            return value;
+        } catch (...) {
+            forget(key);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    // 搭便车（未发起请求）的调用次数
+    size_t coalesced_count() const { return coalesced_.load(std::memory_order_relaxed); }
+
+private:
+    void forget(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_flight_.erase(key);
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<Key, std::shared_future<Value>, Hash> in_flight_;
+    std::atomic<size_t> coalesced_{0};
+};
+
+// 分片的有界 TTL 缓存：每个分片独立加锁并按 LRU 淘汰，读者只竞争所在分片的锁
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t SHARD_COUNT = 16;
+
+    explicit ShardedCache(size_t capacity = 4096) { set_capacity(capacity); }
+
+    // 命中且未过期时返回副本，过期条目在读取时顺带删除
+    std::optional<Value> get(const Key& key) {
+        auto& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        if (it->second.expires_at <= Clock::now()) {
+            shard.lru.erase(it->second.lru_position);
+            shard.entries.erase(it);
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru_position);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return it->second.value;
+    }
+
+    void put(const Key& key, Value value, Clock::duration ttl) {
+        if (ttl <= Clock::duration::zero()) {
+            return;
+        }
+
+        auto& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto expires_at = Clock::now() + ttl;
+        if (auto it = shard.entries.find(key); it != shard.entries.end()) {
+            it->second.value = std::move(value);
+            it->second.expires_at = expires_at;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru_position);
+            return;
+        }
+
+        shard.lru.push_front(key);
+        shard.entries.emplace(key, Entry{std::move(value), expires_at, shard.lru.begin()});
+        evict_overflow(shard);
+    }
+
+    // 总容量按分片均分，缩容时立即淘汰多余条目
+    void set_capacity(size_t capacity) {
+        size_t per_shard = std::max<size_t>(1, (capacity + SHARD_COUNT - 1) / SHARD_COUNT);
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.capacity = per_shard;
+            evict_overflow(shard);
+        }
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+            shard.lru.clear();
+        }
+    }
+
+    size_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    size_t misses() const { return misses_.load(std::memory_order_relaxed); }
+    size_t evictions() const { return evictions_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        Value value;
+        Clock::time_point expires_at;
+        typename std::list<Key>::iterator lru_position;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<Key, Entry, Hash> entries;
+        std::list<Key> lru;  // 头部为最近使用
+        size_t capacity = 1;
+    };
+
+    Shard& shard_for(const Key& key) {
+        // 乘法散列取高位，避免与 unordered_map 的桶下标使用相同的低位
+        uint64_t mixed = static_cast<uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ULL;
+        return shards_[mixed >> 60];
+    }
+
+    void evict_overflow(Shard& shard) {
+        while (shard.entries.size() > shard.capacity) {
+            shard.entries.erase(shard.lru.back());
+            shard.lru.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static_assert(SHARD_COUNT == 16, "shard_for 取乘法散列的高 4 位");
+
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+    std::atomic<size_t> evictions_{0};
+};
+
+// 行情缓存参数
+struct CacheConfig {
+    bool enabled = true;
+    size_t capacity = 8192;                     // 实时行情与K线各自的最大条目数
+    std::chrono::milliseconds quote_ttl{1000};  // 实时行情有效期；K线缓存到当前K线结束
+};
+
+// 客户端限流参数
+struct RateLimitConfig {
+    bool enabled = true;                            // 按 DataProvider::get_rate_limit() 整形请求
+    std::chrono::milliseconds burst_window{10000};  // 允许突发使用的配额时长
+};
+
+// 熔断器参数
+struct CircuitBreakerConfig {
+    int failure_threshold = 5;                       // 连续失败该次数后熔断
+    std::chrono::milliseconds open_duration{30000};  // 熔断持续时间，之后放行一次半开探测
+    double ewma_alpha = 0.2;                         // 成功率与延迟的指数加权系数
+    double degraded_success_rate = 0.8;              // 成功率低于该值标记为 DEGRADED
+    std::chrono::milliseconds rate_limited_duration{60000};  // 上游限流后的冷却时间
+};
+
+// 对冲请求参数
+struct HedgePolicy {
+    double percentile = 0.95;                      // 等待主提供者自身延迟的该分位数
+    std::chrono::milliseconds min_delay{10};       // 对冲等待下限
+    std::chrono::milliseconds default_delay{500};  // 延迟样本不足时的等待时间
+    uint64_t min_samples = 20;                     // 使用分位数所需的最少样本数
+    size_t max_in_flight = 8;  // 本聚合器仍在执行的对冲请求数上限（不含主请求），达到后不再对冲
+};
+
 // 数据提供者基类
 class DataProvider {
 public:
@@ -40,6 +287,13 @@ public:
     // 获取实时行情
     virtual std::optional<MarketTick> get_realtime_quote(const Symbol& symbol) = 0;
 
+    // 批量获取实时行情，结果与输入一一对应；默认逐个调用 get_realtime_quote
+    virtual std::vector<std::optional<MarketTick>> get_realtime_quotes(
+        std::span<const Symbol> symbols);
+
+    // 单次批量请求支持的最大证券数量
+    virtual size_t get_max_batch_size() const { return 1; }
+
     // 获取K线数据
     virtual std::vector<OHLCV> get_kline_data(const Symbol& symbol,
                                               KlinePeriod period = KlinePeriod::DAY_1,
@@ -53,9 +307,33 @@ public:
     // 健康检查
     virtual bool health_check() = 0;
 
+    // 读取并清除上游限流信号（429或空响应），由聚合器在请求失败后调用
+    bool take_rate_limited_signal() { return rate_limited_.exchange(false); }
+
+    // 读取并清除请求失败信号（连接失败、非 200 响应或响应无法解析），由聚合器在每次请求后调用；
+    // 没有该信号时，空结果表示上游正常答复了"无数据"（停牌、退市或未知证券），不计入失败
+    bool take_request_failed_signal() { return request_failed_.exchange(false); }
+
 protected:
+    // 根据HTTP响应判断是否触发了上游限流或请求失败
+    void note_http_status(int status, size_t body_size) {
+        if (status == 429 || (status == 200 && body_size == 0)) {
+            rate_limited_.store(true, std::memory_order_relaxed);
+        }
+        if (status != 200) {
+            request_failed_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // 连接失败或响应无法解析
+    void note_request_failed() { request_failed_.store(true, std::memory_order_relaxed); }
+
     mutable std::mutex mutex_;
     ProviderHealth health_;
+
+private:
+    std::atomic<bool> rate_limited_{false};
+    std::atomic<bool> request_failed_{false};
 };
 
 // 数据获取策略基类
@@ -68,7 +346,19 @@ public:
         DataType data_type,
         const std::vector<std::shared_ptr<DataProvider>>& available_providers) = 0;
 
+    // 结合提供者健康状态选择，health 与 available_providers 一一对应；默认忽略健康信息
+    virtual std::vector<std::shared_ptr<DataProvider>> select_providers_with_health(
+        DataType data_type,
+        const std::vector<std::shared_ptr<DataProvider>>& available_providers,
+        const std::vector<ProviderHealth>& health) {
+        (void)health;
+        return select_providers(data_type, available_providers);
+    }
+
     virtual std::string get_strategy_name() const = 0;
+
+    // 对冲请求参数，nullopt 表示按顺序故障转移
+    virtual std::optional<HedgePolicy> hedge_policy() const { return std::nullopt; }
 };
 
 // 故障转移策略
@@ -95,21 +385,44 @@ private:
     mutable std::map<std::string, size_t> next_provider_index_;
 };
 
-// 加权随机策略（根据成功率选择）
+// 加权随机策略：按成功率与平均延迟加权，返回完整的有序候选列表以便故障转移
 class WeightedRandomStrategy : public DataStrategy {
 public:
+    // 没有健康信息时所有提供者等权
     std::vector<std::shared_ptr<DataProvider>> select_providers(
         DataType data_type,
         const std::vector<std::shared_ptr<DataProvider>>& available_providers) override;
 
+    std::vector<std::shared_ptr<DataProvider>> select_providers_with_health(
+        DataType data_type,
+        const std::vector<std::shared_ptr<DataProvider>>& available_providers,
+        const std::vector<ProviderHealth>& health) override;
+
     std::string get_strategy_name() const override { return "WeightedRandom"; }
+
+    // 单个提供者的权重：成功率越高、延迟越低权重越大
+    static double provider_weight(const ProviderHealth& health, double fallback_latency_ms);
+};
+
+// 对冲请求策略：沿用故障转移的优先级排序，主提供者超过其延迟分位数仍未返回时
+// 向下一个提供者发出同样的请求
+class HedgedStrategy : public FailoverStrategy {
+public:
+    explicit HedgedStrategy(HedgePolicy policy = {}) : policy_(policy) {}
+
+    std::string get_strategy_name() const override { return "Hedged"; }
+
+    std::optional<HedgePolicy> hedge_policy() const override { return policy_; }
+
+private:
+    HedgePolicy policy_;
 };
 
 // 聚合数据管理器
 class DataAggregator {
 public:
     DataAggregator() = default;
-    ~DataAggregator() = default;
+    ~DataAggregator();  // 等待对冲路径中尚未结束的后台请求
 
     // 注册数据提供者
     void register_provider(std::shared_ptr<DataProvider> provider);
@@ -118,13 +431,26 @@ public:
     // 设置获取策略
     void set_strategy(std::unique_ptr<DataStrategy> strategy);
 
+    // 设置熔断器参数，对已注册与之后注册的提供者生效
+    void set_circuit_breaker_config(const CircuitBreakerConfig& config);
+
+    // 设置客户端限流参数，对已注册与之后注册的提供者生效
+    void set_rate_limit_config(const RateLimitConfig& config);
+
+    // 设置行情缓存参数；关闭缓存时清空已缓存的数据
+    void set_cache_config(const CacheConfig& config);
+
     // 数据获取方法（带故障转移）
     std::optional<MarketTick> get_realtime_quote(const Symbol& symbol);
     std::vector<OHLCV> get_kline_data(const Symbol& symbol,
                                       KlinePeriod period = KlinePeriod::DAY_1,
                                       int limit = 100);
 
-    // 健康状态管理
+    // 批量实时行情：按提供者的批量上限分块请求，缺失的证券交给下一个提供者补齐
+    std::vector<std::optional<MarketTick>> get_realtime_quotes(std::span<const Symbol> symbols);
+
+    // 健康状态管理：健康状态由每次请求被动更新；
+    // update_provider_health 对熔断冷却期已过的提供者执行 health_check 作为半开探测
     void update_provider_health();
     std::map<std::string, ProviderHealth> get_provider_health() const;
 
@@ -133,15 +459,76 @@ public:
         size_t total_requests = 0;
         size_t successful_requests = 0;
         size_t failed_requests = 0;
+        size_t hedged_requests = 0;  // 触发对冲的次数
+        size_t hedge_wins = 0;       // 对冲请求先于主请求返回的次数
+        size_t pending_attempts = 0;  // 对冲路径中尚未回收的后台请求数
+        size_t short_circuited_requests = 0;  // 因熔断被跳过的提供者次数
+        size_t rate_limited_skips = 0;        // 因本地令牌桶为空被跳过的提供者次数
+        size_t coalesced_requests = 0;        // 与并发的相同请求合并、未单独发出的次数
+        size_t cache_hits = 0;
+        size_t cache_misses = 0;
+        size_t cache_evictions = 0;  // 因容量上限被淘汰的缓存条目数
         std::map<std::string, size_t> provider_usage_count;
+        std::map<std::string, size_t> provider_failure_count;  // 异常、限流或请求失败的次数
     };
     Statistics get_statistics() const;
 
 private:
-    mutable std::mutex mutex_;
+    // 单个提供者的无锁计数器，注册时创建，注销后保留以便统计
+    struct ProviderCounters {
+        std::atomic<size_t> usage_count{0};
+        std::atomic<size_t> failure_count{0};
+        LatencyHistogram latency;
+        TokenBucket rate_limiter;
+
+        // 健康状态与熔断器，由每个提供者独立的 health_mutex 保护
+        mutable std::mutex health_mutex;
+        ProviderHealth health;
+        CircuitBreakerConfig breaker_config;
+        double ewma_latency_ms = 0.0;
+        bool has_samples = false;
+        std::chrono::steady_clock::time_point open_until;
+        bool probe_in_flight = false;
+    };
+
+    // 不可变的提供者快照（写时复制），请求路径只在短锁内拷贝指针
+    struct Snapshot {
+        std::vector<std::shared_ptr<DataProvider>> providers;
+        std::map<const DataProvider*, std::shared_ptr<ProviderCounters>> counters;
+        std::shared_ptr<DataStrategy> strategy;
+    };
+
+    mutable std::mutex mutex_;  // 仅保护下面的注册表与快照指针，不跨网络调用持有
     std::vector<std::shared_ptr<DataProvider>> providers_;
-    std::unique_ptr<DataStrategy> strategy_;
-    Statistics stats_;
+    std::shared_ptr<DataStrategy> strategy_;
+    std::map<std::string, std::shared_ptr<ProviderCounters>> provider_counters_;
+    CircuitBreakerConfig breaker_config_;
+    RateLimitConfig rate_limit_config_;
+    std::shared_ptr<const Snapshot> snapshot_ = std::make_shared<Snapshot>();
+
+    std::atomic<size_t> total_requests_{0};
+    std::atomic<size_t> successful_requests_{0};
+    std::atomic<size_t> failed_requests_{0};
+    std::atomic<size_t> hedged_requests_{0};
+    std::atomic<size_t> hedge_wins_{0};
+    std::atomic<size_t> short_circuited_requests_{0};
+    std::atomic<size_t> rate_limited_skips_{0};
+
+    // 对冲路径发出的后台请求，落后的请求在调用方返回后仍可能在执行
+    mutable std::mutex attempts_mutex_;
+    std::vector<std::future<void>> attempts_;
+    std::atomic<size_t> hedges_in_flight_{0};  // 仍在执行的对冲请求，不含主请求
+
+    // 并发的相同请求共享一次上游调用
+    SingleFlight<RequestKey, std::optional<MarketTick>, RequestKeyHash> quote_flights_;
+    SingleFlight<RequestKey, std::vector<OHLCV>, RequestKeyHash> kline_flights_;
+
+    // 最近结果缓存，命中时不发出网络请求；开关与有效期用原子量，读路径不经过 mutex_
+    std::atomic<bool> cache_enabled_{CacheConfig{}.enabled};
+    std::atomic<int64_t> quote_ttl_ms_{CacheConfig{}.quote_ttl.count()};
+    ShardedCache<RequestKey, MarketTick, RequestKeyHash> quote_cache_{CacheConfig{}.capacity};
+    ShardedCache<RequestKey, std::vector<OHLCV>, RequestKeyHash> kline_cache_{
+        CacheConfig{}.capacity};
 
     // 辅助方法
     template <typename T>
@@ -149,11 +536,51 @@ private:
         DataType data_type,
         std::function<std::optional<T>(std::shared_ptr<DataProvider>)> getter);
 
-    void record_success(const std::string& provider_name);
-    void record_failure(const std::string& provider_name);
-    void update_provider_metrics(std::shared_ptr<DataProvider> provider,
-                                 bool success,
-                                 int64_t response_time_ms);
+    // 对冲路径：请求在后台线程执行，先成功者胜出，落后的结果被丢弃
+    template <typename T>
+    std::optional<T> try_get_data_hedged(
+        const Snapshot& snapshot,
+        const std::vector<std::shared_ptr<DataProvider>>& selected_providers,
+        const HedgePolicy& policy,
+        std::function<std::optional<T>(std::shared_ptr<DataProvider>)> getter);
+
+    std::shared_ptr<const Snapshot> load_snapshot() const;
+    void rebuild_snapshot();  // 调用方需持有 mutex_
+
+    // 过滤掉处于熔断期的提供者
+    std::vector<std::shared_ptr<DataProvider>> available_providers(const Snapshot& snapshot);
+
+    // 发出请求前的准入检查：令牌桶 + 熔断器，不通过时记录跳过原因
+    bool admit(ProviderCounters* counters);
+
+    static std::vector<ProviderHealth> collect_health(
+        const Snapshot& snapshot, const std::vector<std::shared_ptr<DataProvider>>& providers);
+
+    static std::shared_ptr<ProviderCounters> find_counters(const Snapshot& snapshot,
+                                                           const DataProvider* provider);
+    static std::chrono::milliseconds hedge_delay(const ProviderCounters* counters,
+                                                 const HedgePolicy& policy);
+
+    // 保存新发出的后台请求，同时回收已结束的请求
+    void keep_attempt(std::future<void> attempt);
+
+    // 以下方法只访问提供者计数器，可在后台请求线程中调用
+    static bool accepts_traffic(ProviderCounters* counters);
+    static bool acquire_permit(ProviderCounters* counters);  // 半开状态只放行一个探测请求
+    static void record_success(ProviderCounters* counters);
+    static void record_failure(ProviderCounters* counters);
+    static void update_provider_metrics(ProviderCounters* counters,
+                                        bool success,
+                                        int64_t response_time_ms);
+    static void mark_rate_limited(ProviderCounters* counters);
+
+    // 请求结束后的统一记录：指标、失败计数与上游限流信号；
+    // 抛出异常、限流与提供者报告的请求失败计为失败，正常答复的空结果不影响熔断器
+    static void record_outcome(DataProvider& provider,
+                               ProviderCounters* counters,
+                               bool success,
+                               bool threw,
+                               int64_t response_time_ms);
 };
 
 }  // namespace cppshares::data
\ No newline at end of file
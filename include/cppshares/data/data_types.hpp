@@ -1,10 +1,19 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <type_traits>
+
+#include "cppshares/utils/price.hpp"
+#include "cppshares/utils/symbol_registry.hpp"
 
 namespace cppshares::data {
 
+using utils::INVALID_SYMBOL_ID;
+using utils::SymbolId;
+
 // 数据类型枚举
 enum class DataType { REALTIME_QUOTE, KLINE_DATA, HISTORICAL_DATA, MARKET_DEPTH, TRADE_DETAIL };
 
@@ -41,37 +50,99 @@ enum class SecurityType {
     OPTION        // 期权
 };
 
-// 符号结构
-struct Symbol {
-    std::string code;   // 证券代码
-    Market market;      // 市场
-    SecurityType type;  // 证券类型
+// 各证券类型报价的小数位：股票 2 位，ETF、可转债与债券 3 位；
+// 指数点位、期权报价取 Price 的全部 4 位，期货各合约的报价单位不同，同样不做取整
+constexpr int price_decimals(SecurityType type) {
+    switch (type) {
+        case SecurityType::STOCK:
+            return 2;
+        case SecurityType::ETF:
+        case SecurityType::CONVERTIBLE:
+        case SecurityType::BOND:
+            return 3;
+        default:
+            return utils::Price::DECIMALS;
+    }
+}
+
+// 最小报价单位
+constexpr utils::Price price_tick(SecurityType type) {
+    int64_t raw = 1;
+    for (int i = price_decimals(type); i < utils::Price::DECIMALS; ++i) {
+        raw *= 10;
+    }
+    return utils::Price::from_raw(raw);
+}
+
+// 浮点价格按证券类型的最小报价单位取整为定点价格
+inline utils::Price to_price(double value, SecurityType type) {
+    return utils::Price::from_double(value).round_to(price_tick(type));
+}
+
+// splitmix64 的混合函数：输入的每一位都会影响输出的所有位
+constexpr uint64_t mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// 符号结构：代码、市场与类型打包为一个 64 位键，可平凡复制，比较与哈希均为 O(1)
+// 键的布局（高位到低位）：4 位保留 | 9 个代码字符，每个 6 位 | 市场 3 位 | 类型 3 位
+// 代码字符限于 0-9、A-Z、a-z 与 '-'，最长 9 个字符，超出时构造函数抛出 std::invalid_argument
+class Symbol {
+public:
+    static constexpr size_t MAX_CODE_LENGTH = 9;
 
-    // 构造函数
-    Symbol(const std::string& code, Market market, SecurityType type = SecurityType::STOCK)
-        : code(code), market(market), type(type) {}
+    Symbol(std::string_view code, Market market, SecurityType type = SecurityType::STOCK);
 
-    // 从字符串解析符号
-    static Symbol parse(const std::string& symbol_str);
+    // 代码能否放入打包键；不抛异常的构造
+    static bool is_packable(std::string_view code);
+    static std::optional<Symbol> try_pack(std::string_view code,
+                                          Market market,
+                                          SecurityType type = SecurityType::STOCK);
+
+    // 从字符串解析符号，格式为 "CODE.MARKET.TYPE"，从不抛出异常：
+    // 缺少或无法识别的市场、类型取沪市、股票；没有分隔符时整体作为代码；
+    // 代码放不进打包键时记一条警告并只保留其中可编码的字符（最多 9 个），
+    // 因此不同名称可能得到同一证券，如 "^GSPC.US.INDEX" 与 "GSPC.US.INDEX"
+    static Symbol parse(std::string_view symbol_str);
+    // 与 parse 相同，但代码放不进打包键时返回空，不做截断
+    static std::optional<Symbol> try_parse(std::string_view symbol_str);
+    // 只取名称中的证券类型，规则与 parse 一致，不受代码截断影响
+    static SecurityType parse_type(std::string_view symbol_str);
 
     // 转换为字符串
     std::string to_string() const;
 
-    // 比较运算符
-    bool operator==(const Symbol& other) const {
-        return code == other.code && market == other.market && type == other.type;
-    }
+    std::string code() const;  // 不超过 9 个字符，不会分配堆内存
+    Market market() const { return static_cast<Market>((key_ >> 3) & 0x7); }
+    SecurityType type() const { return static_cast<SecurityType>(key_ & 0x7); }
+
+    uint64_t key() const { return key_; }
+
+    // 全局注册表中的 id，首次调用时注册
+    SymbolId id() const;
+    // 由 id 还原证券，id 未注册或名称中的代码放不进打包键时抛出异常
+    static Symbol from_id(SymbolId id);
+
+    bool operator==(const Symbol& other) const = default;
+
+private:
+    Symbol() = default;
+
+    uint64_t key_ = 0;
 };
 
+static_assert(std::is_trivially_copyable_v<Symbol> && sizeof(Symbol) == sizeof(uint64_t));
+
 }  // namespace cppshares::data
 
-// 为Symbol提供hash支持，用于unordered_map
+// 为Symbol提供hash支持，用于unordered_map；对打包键做 splitmix64 混合
 namespace std {
 template <>
 struct hash<cppshares::data::Symbol> {
     size_t operator()(const cppshares::data::Symbol& symbol) const {
-        return hash<string>()(symbol.code) ^ (hash<int>()(static_cast<int>(symbol.market)) << 1) ^
-               (hash<int>()(static_cast<int>(symbol.type)) << 2);
+        return static_cast<size_t>(cppshares::data::mix64(symbol.key()));
     }
 };
-}  // namespace std
\ No newline at end of file
+}  // namespace std
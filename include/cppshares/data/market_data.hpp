@@ -4,11 +4,18 @@
 #include <string>
 #include <vector>
 
+#include "data_types.hpp"
+
 namespace cppshares::data {
 
-// 市场数据结构
+// 由 id 在注册表中的名称取证券类型，未注册的 id 按股票处理；查询不加锁、不分配内存
+inline SecurityType security_type_of(SymbolId id) {
+    return Symbol::parse_type(utils::SymbolRegistry::global().name(id));
+}
+
+// 市场数据结构；证券以全局注册表中的 id 表示，名称按需查询
 struct MarketTick {
-    std::string symbol;
+    SymbolId symbol_id = INVALID_SYMBOL_ID;
     double price;
     uint64_t volume;
     double bid_price;
@@ -18,11 +25,24 @@ struct MarketTick {
     double change_rate;    // 涨跌幅
     double change_amount;  // 涨跌额
     std::chrono::system_clock::time_point timestamp;
+
+    const std::string& symbol_name() const {
+        return utils::SymbolRegistry::global().name(symbol_id);
+    }
+
+    // 定点价格，按证券类型的最小报价单位取整，需要精确比较价格的场合（撮合、回测）使用；
+    // 不传类型时由 symbol_id 查注册表，调用方已知类型时可直接传入
+    utils::Price fixed_price() const { return fixed_price(security_type_of(symbol_id)); }
+    utils::Price fixed_bid_price() const { return fixed_bid_price(security_type_of(symbol_id)); }
+    utils::Price fixed_ask_price() const { return fixed_ask_price(security_type_of(symbol_id)); }
+    utils::Price fixed_price(SecurityType type) const { return to_price(price, type); }
+    utils::Price fixed_bid_price(SecurityType type) const { return to_price(bid_price, type); }
+    utils::Price fixed_ask_price(SecurityType type) const { return to_price(ask_price, type); }
 };
 
 // K线数据结构
 struct OHLCV {
-    std::string symbol;
+    SymbolId symbol_id = INVALID_SYMBOL_ID;
     std::chrono::system_clock::time_point timestamp;
     double open;
     double high;
@@ -30,6 +50,20 @@ struct OHLCV {
     double close;
     uint64_t volume;
     double amount;  // 成交金额
+
+    const std::string& symbol_name() const {
+        return utils::SymbolRegistry::global().name(symbol_id);
+    }
+
+    // 定点价格，取整规则同 MarketTick
+    utils::Price fixed_open() const { return fixed_open(security_type_of(symbol_id)); }
+    utils::Price fixed_high() const { return fixed_high(security_type_of(symbol_id)); }
+    utils::Price fixed_low() const { return fixed_low(security_type_of(symbol_id)); }
+    utils::Price fixed_close() const { return fixed_close(security_type_of(symbol_id)); }
+    utils::Price fixed_open(SecurityType type) const { return to_price(open, type); }
+    utils::Price fixed_high(SecurityType type) const { return to_price(high, type); }
+    utils::Price fixed_low(SecurityType type) const { return to_price(low, type); }
+    utils::Price fixed_close(SecurityType type) const { return to_price(close, type); }
 };
 
 }  // namespace cppshares::data
\ No newline at end of file
@@ -262,6 +262,9 @@ namespace FieldSets {
 // 基础行情数据 - 价格、涨跌、成交量
 constexpr const char* BASIC_QUOTE = "f2,f3,f4,f5,f6,f15,f16,f17,f18";
 
+// 批量行情数据 - 基础行情加代码/市场/买卖价，用于ulist.np接口按证券回填结果
+constexpr const char* BATCH_QUOTE = "f2,f3,f4,f5,f6,f12,f13,f15,f16,f17,f18,f31,f32";
+
 // 完整行情数据 - 包含市值、比率等
 constexpr const char* FULL_QUOTE = "f2,f3,f4,f5,f6,f7,f8,f9,f10,f12,f14,f15,f16,f17,f18,f20,f21,f22,f23";
 
@@ -3,6 +3,9 @@
 #include <httplib.h>
 
 #include <nlohmann/json.hpp>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 
 #include "../data_strategy.hpp"
 #include "../data_types.hpp"
@@ -20,6 +23,11 @@ public:
     // DataProvider 接口实现
     std::optional<MarketTick> get_realtime_quote(const Symbol& symbol) override;
 
+    // 通过 ulist.np 接口一次请求多只证券
+    std::vector<std::optional<MarketTick>> get_realtime_quotes(
+        std::span<const Symbol> symbols) override;
+    size_t get_max_batch_size() const override { return MAX_BATCH_SIZE; }
+
     std::vector<OHLCV> get_kline_data(const Symbol& symbol,
                                       KlinePeriod period = KlinePeriod::DAY_1,
                                       int limit = 100) override;
@@ -30,19 +38,46 @@ public:
 
     bool health_check() override;
 
+    // 增量K线：记住每个 (证券, 周期) 的本地历史，之后只请求最后一根K线及更新的数据
+    void set_incremental_kline(bool enabled);
+
+    // 将新拉取的K线并入本地历史：替换重叠部分（含尚未收盘的最后一根），追加更新的K线；
+    // 新数据与历史不衔接时（中间可能缺口）以新数据替换整个历史并返回 false
+    static bool merge_klines(std::vector<OHLCV>& history, std::vector<OHLCV> fresh);
+
+    // 解析单行K线 "日期,开,收,高,低,量,额,..."，不分配内存；格式或数值无效时返回空
+    // 日期按北京时间解释，symbol 由调用方填写
+    static std::optional<OHLCV> parse_kline_row(std::string_view row);
+
 private:
     static constexpr const char* BASE_URL = "push2.eastmoney.com";
     static constexpr const char* KLINE_URL = "push2his.eastmoney.com";
+    static constexpr size_t MAX_BATCH_SIZE = 200;  // secids 参数单次携带的证券数量上限
 
     httplib::Client client_;
     httplib::Client kline_client_;
 
+    // 本地K线历史，由 kline_mutex_ 保护
+    struct KlineSeries {
+        std::vector<OHLCV> bars;
+        int depth = 0;  // 历史对应的最大请求条数，更大的 limit 需要重新全量拉取
+    };
+    std::mutex kline_mutex_;
+    bool incremental_kline_ = true;
+    std::unordered_map<std::string, KlineSeries> kline_history_;
+
     // 辅助方法
     std::string format_symbol_for_eastmoney(const Symbol& symbol);
     std::optional<MarketTick> parse_realtime_response(const std::string& response,
                                                       const Symbol& symbol);
+    std::vector<std::optional<MarketTick>> parse_batch_realtime_response(
+        const std::string& response, std::span<const Symbol> symbols);
     std::vector<OHLCV> parse_kline_response(const std::string& response, const Symbol& symbol);
     std::string period_to_eastmoney_format(KlinePeriod period);
+    std::optional<std::vector<OHLCV>> fetch_klines(const Symbol& symbol,
+                                                   KlinePeriod period,
+                                                   const std::string& begin_date,
+                                                   int limit);
 };
 
 }  // namespace cppshares::data::providers
\ No newline at end of file
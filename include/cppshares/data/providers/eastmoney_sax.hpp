@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "../market_data.hpp"
+
+namespace cppshares::data::providers {
+
+// 流式解码结果
+enum class SaxDecodeStatus {
+    OK,         // 解码成功
+    NO_DATA,    // 结构符合预期但没有可用数据，如 "data": null 或停牌时价格为 "-"
+    UNEXPECTED  // JSON 无效或结构不符合预期，调用方应回退到 DOM 解析
+};
+
+// 东方财富响应的 SAX 解码：不构建 nlohmann::json DOM，直接写入 MarketTick / OHLCV
+namespace EastMoneySax {
+
+// 单只实时行情 {"data": {"f2": 价格, "f5": 成交量, ...}}，只填写价格与成交量
+SaxDecodeStatus decode_quote(std::string_view response, MarketTick& tick);
+
+// K线 {"data": {"klines": ["日期,开,收,高,低,量,额,...", ...]}}
+// 无效的K线行被跳过并计入 invalid_rows
+SaxDecodeStatus decode_klines(std::string_view response,
+                              std::vector<OHLCV>& klines,
+                              size_t& invalid_rows);
+
+}  // namespace EastMoneySax
+
+}  // namespace cppshares::data::providers
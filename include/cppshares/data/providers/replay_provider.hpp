@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "../data_strategy.hpp"
+#include "../market_data.hpp"
+#include "cppshares/utils/binary_log_reader.hpp"
+
+namespace cppshares::data::providers {
+
+// 回放参数
+struct ReplayConfig {
+    double speed = 1.0;  // 1 为原始节奏，N 为 N 倍速，0 表示不等待、尽快回放
+    utils::LogReadMode read_mode = utils::LogReadMode::RECOVER;  // 默认跳过损坏的块
+};
+
+// 二进制日志回放：按记录时间戳的节奏重放行情记录（含定点格式）
+// 同时作为 DataProvider 提供回放进度对应的最新行情，策略可以像实盘一样通过 DataAggregator 取数
+// （经 DataAggregator 取数时应关闭行情缓存，否则会读到缓存中较早的行情）
+class ReplayProvider : public DataProvider {
+public:
+    // 每条行情的回调，返回 false 时停止回放
+    using TickCallback = std::function<bool(const MarketTick&)>;
+
+    explicit ReplayProvider(const std::string& log_path, ReplayConfig config = {});
+    ~ReplayProvider() override = default;
+
+    // 记录中的 symbol_id 即全局注册表中的 id；回放其他进程写出的日志前加载其符号映射文件
+    void load_symbol_map(const std::string& symbol_file) {
+        utils::SymbolRegistry::global().load(symbol_file);
+    }
+
+    // 回放全部行情记录：先更新最新行情再回调，阻塞直到回放结束或被停止，返回回放的记录数
+    size_t replay(const TickCallback& on_tick = {});
+    void stop() { stopping_.store(true, std::memory_order_relaxed); }
+
+    // DataProvider 接口实现
+    std::optional<MarketTick> get_realtime_quote(const Symbol& symbol) override;
+    std::vector<std::optional<MarketTick>> get_realtime_quotes(
+        std::span<const Symbol> symbols) override;
+    size_t get_max_batch_size() const override { return SIZE_MAX; }
+
+    // 日志中只有逐笔行情
+    std::vector<OHLCV> get_kline_data(const Symbol& /*symbol*/,
+                                      KlinePeriod /*period*/ = KlinePeriod::DAY_1,
+                                      int /*limit*/ = 100) override {
+        return {};
+    }
+
+    std::string get_name() const override { return "BinaryLogReplay"; }
+    int get_priority() const override { return 0; }    // 回放时优先于实盘数据源
+    int get_rate_limit() const override { return 0; }  // 不限流
+
+    bool health_check() override { return true; }
+
+private:
+    struct Quote {
+        double price = 0.0;
+        uint64_t volume = 0;
+        uint64_t unix_us = 0;
+    };
+
+    static void fill_tick(MarketTick& tick, const Quote& quote);
+
+    utils::BinaryLogReader reader_;
+    ReplayConfig config_;
+    std::vector<std::optional<Quote>> latest_;  // 按 symbol_id 下标存放，由 mutex_ 保护
+    std::atomic<bool> stopping_{false};
+};
+
+}  // namespace cppshares::data::providers
@@ -19,6 +19,11 @@ public:
     // DataProvider 接口实现
     std::optional<MarketTick> get_realtime_quote(const Symbol& symbol) override;
 
+    // 通过 list= 参数一次请求多只证券
+    std::vector<std::optional<MarketTick>> get_realtime_quotes(
+        std::span<const Symbol> symbols) override;
+    size_t get_max_batch_size() const override { return MAX_BATCH_SIZE; }
+
     std::vector<OHLCV> get_kline_data(const Symbol& symbol,
                                       KlinePeriod period = KlinePeriod::DAY_1,
                                       int limit = 100) override;
@@ -29,15 +34,20 @@ public:
 
     bool health_check() override;
 
+    // 解析 list= 批量响应，结果与 symbols 一一对应；停牌或尚无成交（现价不大于 0）的行为空
+    static std::vector<std::optional<MarketTick>> parse_batch_realtime_response(
+        const std::string& response, std::span<const Symbol> symbols);
+
 private:
     static constexpr const char* BASE_URL = "hq.sinajs.cn";
     static constexpr const char* KLINE_URL = "money.finance.sina.com.cn";
+    static constexpr size_t MAX_BATCH_SIZE = 200;  // list 参数单次携带的证券数量上限
 
     httplib::Client client_;
     httplib::Client kline_client_;
 
     // 辅助方法
-    std::string format_symbol_for_sina(const Symbol& symbol);
+    static std::string format_symbol_for_sina(const Symbol& symbol);
     std::optional<MarketTick> parse_realtime_response(const std::string& response,
                                                       const Symbol& symbol);
     std::vector<OHLCV> parse_kline_response(const std::string& response, const Symbol& symbol);
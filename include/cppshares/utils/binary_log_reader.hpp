@@ -1,48 +1,575 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
 #include <format>
 #include <fstream>
-#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "binary_log_segment.hpp"
+#include "crc32c.hpp"
 #include "logger.hpp"
+#include "mapped_file.hpp"
+#include "symbol_registry.hpp"
 
 namespace cppshares::utils {
 
+// 映射文件中一条记录的零拷贝视图，仅在所属 BinaryLogReader 存活期间有效
+struct BinaryLogRecord {
+    const BinaryLogEntry* header = nullptr;  // 指向映射内存，packed 结构无对齐要求
+    std::span<const char> payload;           // 变长数据部分
+    uint64_t unix_us = 0;                    // 按最近一条校准记录换算后的时间戳
+
+    uint32_t event_type() const { return header->event_type; }
+
+    // 按记录类型复制出数据部分；数据部分长度不足时返回空
+    template <typename Record>
+    std::optional<Record> as() const {
+        if (payload.size() < sizeof(Record)) {
+            return std::nullopt;
+        }
+        Record record;
+        std::memcpy(&record, payload.data(), sizeof(Record));
+        return record;
+    }
+
+    // 行情记录，FixedMarketDataRecord 换算为 MarketDataRecord；其他类型返回空
+    std::optional<MarketDataRecord> market_data() const {
+        if (event_type() == MarketDataRecord::TYPE_ID) {
+            return as<MarketDataRecord>();
+        }
+        if (event_type() != FixedMarketDataRecord::TYPE_ID) {
+            return std::nullopt;
+        }
+        auto fixed = as<FixedMarketDataRecord>();
+        if (!fixed) {
+            return std::nullopt;
+        }
+        return MarketDataRecord{.symbol_id = fixed->symbol_id,
+                                .price = Price::from_raw(fixed->price).to_double(),
+                                .volume = fixed->volume,
+                                .side = fixed->side,
+                                .padding = {0, 0, 0}};
+    }
+};
+
+// 行情记录的两种格式
+inline bool is_market_data(uint32_t event_type) {
+    return event_type == MarketDataRecord::TYPE_ID || event_type == FixedMarketDataRecord::TYPE_ID;
+}
+
+// 按记录类型过滤；以 MarketDataRecord::TYPE_ID 过滤时两种行情格式都匹配
+inline bool matches_event_type(std::optional<uint32_t> filter, uint32_t event_type) {
+    return !filter || event_type == *filter ||
+           (*filter == MarketDataRecord::TYPE_ID && is_market_data(event_type));
+}
+
+// 记录的前向迭代器，跳过文件头与块标记，只产出日志记录（含校准记录）
+// 默认遇到写入中断留下的不完整尾部记录时视为结束；verify 模式下逐块校验 CRC，
+// 遇到损坏或不完整的块时跳到下一个块标记重新同步
+// 迭代器自身携带时钟校准状态，因此时间戳换算不依赖读取器的可变状态
+class BinaryLogIterator {
+public:
+    using value_type = BinaryLogRecord;
+    using difference_type = std::ptrdiff_t;
+    using iterator_concept = std::forward_iterator_tag;
+
+    BinaryLogIterator() = default;
+    BinaryLogIterator(const char* pos, const char* end) : pos_(pos), end_(end) { load(); }
+
+    // 从文件中间开始迭代时需要给出该位置生效的时钟校准
+    BinaryLogIterator(const char* pos,
+                      const char* end,
+                      const TscCalibration& clock,
+                      bool verify = false)
+        : pos_(pos), end_(end), clock_(clock), verify_(verify) {
+        load();
+    }
+
+    BinaryLogRecord operator*() const { return current_; }
+
+    BinaryLogIterator& operator++() {
+        pos_ += sizeof(BinaryLogEntry) + current_.payload.size();
+        load();
+        return *this;
+    }
+
+    BinaryLogIterator operator++(int) {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    bool operator==(const BinaryLogIterator& other) const { return pos_ == other.pos_; }
+
+    const TscCalibration& clock() const { return clock_; }
+
+    // verify 模式下重新同步的次数（连续的损坏区域计一次）与跳过的字节数
+    uint64_t resyncs() const { return resyncs_; }
+    uint64_t skipped_bytes() const { return skipped_bytes_; }
+
+private:
+    // block_end_ 为空表示尚未进入校验过的块（旧格式日志或从块中间开始迭代），此时信任记录长度
+    void load() {
+        while (pos_ != end_) {
+            auto remaining = static_cast<size_t>(end_ - pos_);
+            if (remaining < sizeof(BinaryLogEntry)) {
+                resync();
+                continue;
+            }
+            const auto* header = reinterpret_cast<const BinaryLogEntry*>(pos_);
+            if (header->data_size > remaining - sizeof(BinaryLogEntry)) {
+                resync();
+                continue;
+            }
+
+            std::span<const char> payload(pos_ + sizeof(BinaryLogEntry), header->data_size);
+            const char* next = payload.data() + payload.size();
+            bool at_boundary = verify_ && pos_ == block_end_;
+            if (verify_ && block_end_ != nullptr && !at_boundary && next > block_end_) {
+                resync();
+                continue;
+            }
+
+            if (header->event_type == BlockMarkerRecord::TYPE_ID) {
+                if (verify_ && !enter_block(payload, next)) {
+                    resync();
+                    continue;
+                }
+                pos_ = next;
+                continue;
+            }
+            if (header->event_type == LogFileHeaderRecord::TYPE_ID) {
+                // 文件头之后必须是块标记
+                if (verify_ && (block_end_ == nullptr || at_boundary)) {
+                    block_end_ = next;
+                }
+                pos_ = next;
+                continue;
+            }
+            if (at_boundary) {
+                resync();
+                continue;
+            }
+
+            emit(header, payload);
+            return;
+        }
+    }
+
+    // 校验块标记及其覆盖的记录
+    bool enter_block(std::span<const char> payload, const char* next) {
+        if (payload.size() < sizeof(BlockMarkerRecord)) {
+            return false;
+        }
+        BlockMarkerRecord marker;
+        std::memcpy(&marker, payload.data(), sizeof(marker));
+        if (std::memcmp(marker.magic, BINARY_LOG_BLOCK_MAGIC, sizeof(marker.magic)) != 0 ||
+            marker.block_size > static_cast<size_t>(end_ - next) ||
+            crc32c(next, marker.block_size) != marker.crc) {
+            return false;
+        }
+        block_end_ = next + marker.block_size;
+        resyncing_ = false;
+        return true;
+    }
+
+    // 当前位置无法解析：默认视为结束，verify 模式下跳到下一个块标记
+    void resync() {
+        if (!verify_) {
+            pos_ = end_;
+            return;
+        }
+        if (!resyncing_) {
+            resyncs_++;
+            resyncing_ = true;
+        }
+
+        const char* next = end_;
+        if (static_cast<size_t>(end_ - pos_) > sizeof(BinaryLogEntry) + 1) {
+            const char* search_from = pos_ + sizeof(BinaryLogEntry) + 1;
+            std::string_view rest(search_from, static_cast<size_t>(end_ - search_from));
+            auto found = rest.find(
+                std::string_view(BINARY_LOG_BLOCK_MAGIC, sizeof(BINARY_LOG_BLOCK_MAGIC)));
+            if (found != std::string_view::npos) {
+                next = search_from + found - sizeof(BinaryLogEntry);
+            }
+        }
+        skipped_bytes_ += static_cast<uint64_t>(next - pos_);
+        pos_ = next;
+        block_end_ = next;  // 下一个位置必须是有效的块标记
+    }
+
+    void emit(const BinaryLogEntry* header, std::span<const char> payload) {
+        if (header->event_type == ClockCalibrationRecord::TYPE_ID &&
+            payload.size() >= sizeof(ClockCalibrationRecord)) {
+            ClockCalibrationRecord record;
+            std::memcpy(&record, payload.data(), sizeof(record));
+            clock_ = {.reference_ticks = record.reference_ticks,
+                      .reference_unix_ns = record.reference_unix_ns,
+                      .ns_per_tick = record.ns_per_tick};
+        }
+        current_ = {
+            .header = header, .payload = payload, .unix_us = to_unix_us(header->timestamp_us)};
+    }
+
+    // 时间戳换算：遇到校准记录前按微秒解释，兼容没有校准记录的旧日志
+    uint64_t to_unix_us(uint64_t timestamp) const {
+        if (clock_.ns_per_tick <= 0.0) {
+            return timestamp;
+        }
+        return static_cast<uint64_t>(clock_.to_unix_ns(timestamp) / 1000);
+    }
+
+    const char* pos_ = nullptr;
+    const char* end_ = nullptr;
+    BinaryLogRecord current_;
+    TscCalibration clock_;
+    bool verify_ = false;
+    const char* block_end_ = nullptr;  // 当前已校验块的结束位置
+    bool resyncing_ = false;
+    uint64_t resyncs_ = 0;
+    uint64_t skipped_bytes_ = 0;
+};
+
+// 映射文件上的记录区间，可直接用于 std::ranges 算法与视图适配器
+class BinaryLogRecords : public std::ranges::view_interface<BinaryLogRecords> {
+public:
+    BinaryLogRecords() = default;
+    explicit BinaryLogRecords(std::span<const char> bytes, bool verify = false)
+        : bytes_(bytes), verify_(verify) {}
+
+    BinaryLogIterator begin() const {
+        return {bytes_.data(), bytes_.data() + bytes_.size(), TscCalibration{}, verify_};
+    }
+    BinaryLogIterator end() const {
+        return {bytes_.data() + bytes_.size(), bytes_.data() + bytes_.size()};
+    }
+
+private:
+    std::span<const char> bytes_;
+    bool verify_ = false;
+};
+
+static_assert(std::forward_iterator<BinaryLogIterator>);
+static_assert(std::ranges::forward_range<BinaryLogRecords>);
+
+// 时间索引文件头，索引文件为 <日志文件>.idx
+// 02 版起文件头带有已索引部分的指纹，01 版索引加载失败后重建
+inline constexpr char TIME_INDEX_MAGIC[8] = {'C', 'P', 'S', 'I', 'D', 'X', '0', '2'};
+
+struct TimeIndexHeader {
+    char magic[8];
+    uint64_t bucket_us;                // 时间桶宽度（微秒）
+    uint64_t indexed_size;             // 已建立索引的日志字节数
+    uint64_t last_calibration_offset;  // 已索引部分最后一条校准记录的位置
+    uint64_t entry_count;
+    uint32_t head_crc;  // 已索引部分开头 FINGERPRINT_BYTES 字节的 CRC32C
+    uint32_t tail_crc;  // 已索引部分末尾 FINGERPRINT_BYTES 字节的 CRC32C
+} __attribute__((packed));
+
+// 一个时间桶内某类记录的位置范围
+struct TimeIndexEntry {
+    uint64_t bucket_us;           // 时间桶起点（unix 微秒）
+    uint32_t event_type;          // 记录类型
+    uint32_t record_count;        // 桶内该类记录数
+    uint64_t first_offset;        // 桶内该类第一条记录的文件偏移
+    uint64_t last_offset;         // 桶内该类最后一条记录的文件偏移
+    uint64_t calibration_offset;  // first_offset 处生效的校准记录偏移
+} __attribute__((packed));
+
+// 稀疏时间索引：按 (时间桶, 记录类型) 记录文件偏移范围，按时间桶二分查找
+// 多线程异步写入时时间戳可能轻微乱序，因此每项同时记录首尾偏移，查询结果仍然精确
+class BinaryLogTimeIndex {
+public:
+    static constexpr uint64_t NO_CALIBRATION = UINT64_MAX;
+    static constexpr uint64_t FINGERPRINT_BYTES = 4096;
+
+    explicit BinaryLogTimeIndex(std::chrono::microseconds bucket = std::chrono::seconds(1))
+        : bucket_us_(static_cast<uint64_t>(std::max<int64_t>(bucket.count(), 1))) {}
+
+    static std::string sidecar_path(const std::string& log_path) { return log_path + ".idx"; }
+
+    // 读取索引文件；文件不存在或格式不符时返回 false
+    bool load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        TimeIndexHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, TIME_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+            header.bucket_us == 0) {
+            return false;
+        }
+
+        std::vector<TimeIndexEntry> entries(header.entry_count);
+        if (!file.read(reinterpret_cast<char*>(entries.data()),
+                       static_cast<std::streamsize>(entries.size() * sizeof(TimeIndexEntry)))) {
+            return false;
+        }
+
+        bucket_us_ = header.bucket_us;
+        indexed_size_ = header.indexed_size;
+        last_calibration_offset_ = header.last_calibration_offset;
+        head_crc_ = header.head_crc;
+        tail_crc_ = header.tail_crc;
+        entries_ = std::move(entries);
+        return true;
+    }
+
+    // 先写临时文件再改名，避免读取方看到写了一半的索引
+    bool save(const std::string& path) const {
+        auto temp_path = path + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            TimeIndexHeader header{.magic = {},
+                                   .bucket_us = bucket_us_,
+                                   .indexed_size = indexed_size_,
+                                   .last_calibration_offset = last_calibration_offset_,
+                                   .entry_count = entries_.size(),
+                                   .head_crc = head_crc_,
+                                   .tail_crc = tail_crc_};
+            std::memcpy(header.magic, TIME_INDEX_MAGIC, sizeof(header.magic));
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(entries_.data()),
+                       static_cast<std::streamsize>(entries_.size() * sizeof(TimeIndexEntry)));
+            if (!file) {
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp_path, path, ec);
+        return !ec;
+    }
+
+    // 为 indexed_size 之后新追加的记录补充索引；日志变短，或已索引部分的首尾指纹不符
+    // （日志被轮转、替换或改写）时重建。返回是否有新的记录被索引；verify 时跳过校验失败的块
+    bool extend(std::span<const char> bytes, bool verify = false) {
+        if (indexed_size_ > bytes.size() ||
+            fingerprint(bytes, indexed_size_) != std::pair(head_crc_, tail_crc_)) {
+            entries_.clear();
+            indexed_size_ = 0;
+            last_calibration_offset_ = NO_CALIBRATION;
+        }
+
+        const char* base = bytes.data();
+        const char* end = base + bytes.size();
+        auto indexed_before = indexed_size_;
+
+        BinaryLogIterator it(
+            base + indexed_size_, end, clock_at(bytes, last_calibration_offset_), verify);
+        for (BinaryLogIterator last(end, end); it != last; ++it) {
+            auto record = *it;
+            auto offset =
+                static_cast<uint64_t>(reinterpret_cast<const char*>(record.header) - base);
+            indexed_size_ = offset + sizeof(BinaryLogEntry) + record.payload.size();
+
+            if (record.event_type() == ClockCalibrationRecord::TYPE_ID) {
+                last_calibration_offset_ = offset;
+                continue;
+            }
+            add(record.unix_us - record.unix_us % bucket_us_, record.event_type(), offset);
+        }
+        std::tie(head_crc_, tail_crc_) = fingerprint(bytes, indexed_size_);
+        return indexed_size_ != indexed_before;
+    }
+
+    // 时间桶与 [begin_us, end_us) 相交的索引项
+    std::span<const TimeIndexEntry> entries_between(uint64_t begin_us, uint64_t end_us) const {
+        if (end_us <= begin_us) {
+            return {};
+        }
+        auto first_bucket = begin_us - begin_us % bucket_us_;
+        auto last_bucket = (end_us - 1) - (end_us - 1) % bucket_us_;
+
+        // packed 字段不能绑定引用，投影按值返回
+        auto bucket = [](const TimeIndexEntry& entry) -> uint64_t { return entry.bucket_us; };
+        auto first = std::ranges::lower_bound(entries_, first_bucket, {}, bucket);
+        auto last = std::ranges::upper_bound(entries_, last_bucket, {}, bucket);
+        return {first, last};
+    }
+
+    // 读取 offset 处的校准记录，得到从该处开始生效的时钟
+    static TscCalibration clock_at(std::span<const char> bytes, uint64_t offset) {
+        if (offset == NO_CALIBRATION || offset >= bytes.size()) {
+            return {};
+        }
+        return BinaryLogIterator(bytes.data() + offset, bytes.data() + bytes.size()).clock();
+    }
+
+    std::span<const TimeIndexEntry> entries() const { return entries_; }
+    uint64_t bucket_us() const { return bucket_us_; }
+    uint64_t indexed_size() const { return indexed_size_; }
+
+private:
+    // 前 size 字节首尾各 FINGERPRINT_BYTES 字节的 CRC32C
+    static std::pair<uint32_t, uint32_t> fingerprint(std::span<const char> bytes, uint64_t size) {
+        auto window = std::min(size, FINGERPRINT_BYTES);
+        return {crc32c(bytes.data(), window), crc32c(bytes.data() + size - window, window)};
+    }
+
+    void add(uint64_t bucket_us, uint32_t event_type, uint64_t offset) {
+        auto key = [](const TimeIndexEntry& entry) {
+            return std::pair<uint64_t, uint32_t>(entry.bucket_us, entry.event_type);
+        };
+        auto it = std::ranges::lower_bound(
+            entries_, std::pair<uint64_t, uint32_t>(bucket_us, event_type), {}, key);
+        if (it != entries_.end() && it->bucket_us == bucket_us && it->event_type == event_type) {
+            it->record_count++;
+            it->last_offset = offset;
+            return;
+        }
+        // 时间戳基本有序，新项几乎总是追加在末尾
+        entries_.insert(it,
+                        TimeIndexEntry{.bucket_us = bucket_us,
+                                       .event_type = event_type,
+                                       .record_count = 1,
+                                       .first_offset = offset,
+                                       .last_offset = offset,
+                                       .calibration_offset = last_calibration_offset_});
+    }
+
+    uint64_t bucket_us_;
+    uint64_t indexed_size_ = 0;
+    uint64_t last_calibration_offset_ = NO_CALIBRATION;
+    uint32_t head_crc_ = 0;
+    uint32_t tail_crc_ = 0;
+    std::vector<TimeIndexEntry> entries_;  // 按 (时间桶, 记录类型) 排序
+};
+
+// CSV 导出参数
+struct CsvExportConfig {
+    size_t threads = 0;                    // 格式化线程数，0 表示 hardware_concurrency
+    size_t chunk_bytes = 4 * 1024 * 1024;  // 每个分块覆盖的日志字节数
+};
+
+// 读取模式：FAST 信任记录长度，遇到无法解析的位置即停止；
+// RECOVER 逐块校验 CRC，跳过损坏或写了一半的块，在下一个有效块处继续
+enum class LogReadMode { FAST, RECOVER };
+
+// 二进制日志读取器：整文件只读映射，统计与导出直接遍历映射内存，不经过流
 class BinaryLogReader {
 private:
-    std::ifstream binary_file_;
-    std::unordered_map<uint32_t, std::string> symbol_map_;
+    std::string filename_;
+    MappedFile file_;
+    std::optional<CompressedLogReader> compressed_;  // 压缩分段（.binz）
+    mutable std::vector<char> decompressed_;  // 压缩分段整体解压后的内容，首次整体遍历时生成
+    mutable std::span<const char> bytes_;     // 记录所在的内存：映射文件或解压缓冲区
+    SymbolRegistry* symbols_ = &SymbolRegistry::global();
     std::unordered_map<uint32_t, std::string> strategy_map_;
+    CsvExportConfig csv_config_;
+    bool verify_ = false;
 
 public:
-    explicit BinaryLogReader(const std::string& filename)
-        : binary_file_(filename, std::ios::binary) {
-        if (!binary_file_.is_open()) {
-            throw std::runtime_error("Failed to open binary log file: " + filename);
-        }
-    }
-
-    // 加载符号映射
-    void load_symbol_map(const std::string& symbol_file) {
-        std::ifstream file(symbol_file);
-        std::string line;
-        while (std::getline(file, line)) {
-            auto pos = line.find(',');
-            if (pos != std::string::npos) {
-                uint32_t id = std::stoul(line.substr(0, pos));
-                std::string symbol = line.substr(pos + 1);
-                symbol_map_[id] = symbol;
+    // 压缩过的分段（.binz）：按时间查询只解压涉及的块，整体遍历（统计、导出）时才整体解压
+    explicit BinaryLogReader(const std::string& filename, LogReadMode mode = LogReadMode::FAST)
+        : filename_(filename),
+          file_(filename),
+          bytes_(file_.bytes()),
+          verify_(mode == LogReadMode::RECOVER) {
+        if (is_compressed_log(bytes_)) {
+            compressed_.emplace(filename);
+            bytes_ = {};
+        }
+    }
+
+    // 文件中的所有记录（含校准记录，不含文件头与块标记）
+    BinaryLogRecords records() const { return BinaryLogRecords(bytes(), verify_); }
+
+    // 按时间查询时已解压的块数（未压缩的日志为 0）
+    size_t decompressed_blocks() const { return blocks_.size(); }
+
+    // 时间索引：首次使用时加载 <日志文件>.idx，为其后追加的记录补充索引并写回
+    const BinaryLogTimeIndex& time_index() {
+        if (!time_index_) {
+            time_index_.emplace();
+            time_index_->load(BinaryLogTimeIndex::sidecar_path(filename_));
+            update_time_index();
+        }
+        return *time_index_;
+    }
+
+    // 以指定的时间桶宽度重建索引
+    const BinaryLogTimeIndex& build_time_index(
+        std::chrono::microseconds bucket = std::chrono::seconds(1)) {
+        time_index_.emplace(bucket);
+        update_time_index();
+        return *time_index_;
+    }
+
+    // 查询 [begin, end) 内的记录（不含校准记录），可按记录类型过滤
+    // 只扫描索引给出的偏移范围，返回的视图指向映射内存；压缩分段只解压涉及的块
+    std::vector<BinaryLogRecord> records_between(
+        std::chrono::system_clock::time_point begin,
+        std::chrono::system_clock::time_point end,
+        std::optional<uint32_t> event_type = std::nullopt) {
+        auto begin_us = to_microseconds(begin);
+        auto end_us = to_microseconds(end);
+        if (compressed_) {
+            return compressed_records_between(begin_us, end_us, event_type);
+        }
+        const auto& index = time_index();
+
+        uint64_t first_offset = UINT64_MAX;
+        uint64_t last_offset = 0;
+        uint64_t calibration_offset = BinaryLogTimeIndex::NO_CALIBRATION;
+        for (const auto& entry : index.entries_between(begin_us, end_us)) {
+            if (!matches_event_type(event_type, entry.event_type)) {
+                continue;
+            }
+            if (entry.first_offset < first_offset) {
+                first_offset = entry.first_offset;
+                calibration_offset = entry.calibration_offset;
             }
+            last_offset = std::max<uint64_t>(last_offset, entry.last_offset);
         }
+
+        std::vector<BinaryLogRecord> result;
+        if (first_offset == UINT64_MAX) {
+            return result;
+        }
+
+        auto bytes = bytes_;
+        const char* base = bytes.data();
+        const char* end_ptr = base + bytes.size();
+        BinaryLogIterator it(base + first_offset,
+                             end_ptr,
+                             BinaryLogTimeIndex::clock_at(bytes, calibration_offset),
+                             verify_);
+        for (BinaryLogIterator last(end_ptr, end_ptr); it != last; ++it) {
+            auto record = *it;
+            if (static_cast<uint64_t>(reinterpret_cast<const char*>(record.header) - base) >
+                last_offset) {
+                break;
+            }
+            auto type = record.event_type();
+            if (type == ClockCalibrationRecord::TYPE_ID || !matches_event_type(event_type, type) ||
+                record.unix_us < begin_us || record.unix_us >= end_us) {
+                continue;
+            }
+            result.push_back(record);
+        }
+        return result;
     }
 
+    // 加载其他进程写出的符号映射（每行 "id,name"），与当前注册表冲突时抛出异常
+    void load_symbol_map(const std::string& symbol_file) { symbols_->load(symbol_file); }
+
     // 手动注册符号
-    void register_symbol(uint32_t symbol_id, const std::string& symbol) {
-        symbol_map_[symbol_id] = symbol;
+    void register_symbol(SymbolId symbol_id, const std::string& symbol) {
+        symbols_->assign(symbol_id, symbol);
     }
 
     // 注册策略
@@ -50,9 +577,11 @@ public:
         strategy_map_[strategy_id] = strategy_name;
     }
 
+    void set_csv_export_config(const CsvExportConfig& config) { csv_config_ = config; }
+
     // 导出所有数据到CSV
     void export_all_to_csv(const std::string& csv_filename) {
-        std::ofstream csv_file(csv_filename);
+        std::ofstream csv_file(csv_filename, std::ios::binary);
         csv_file << "timestamp,event_type,data\n";
 
         export_records(csv_file, [](uint32_t) { return true; });
@@ -60,11 +589,13 @@ public:
 
     // 导出特定事件类型到CSV
     void export_to_csv(const std::string& csv_filename, uint32_t event_type_filter) {
-        std::ofstream csv_file(csv_filename);
+        std::ofstream csv_file(csv_filename, std::ios::binary);
 
         write_csv_header(csv_file, event_type_filter);
-        export_records(csv_file,
-                       [event_type_filter](uint32_t type) { return type == event_type_filter; });
+        export_records(csv_file, [event_type_filter](uint32_t type) {
+            // 两种行情格式导出为同样的行
+            return matches_event_type(event_type_filter, type);
+        });
     }
 
     // 导出市场数据
@@ -88,24 +619,36 @@ public:
         uint64_t market_data_records = 0;
         uint64_t order_records = 0;
         uint64_t strategy_signal_records = 0;
+        uint64_t calibration_records = 0;
         uint64_t unknown_records = 0;
+        uint64_t resyncs = 0;        // RECOVER 模式下跳过的损坏区域数
+        uint64_t skipped_bytes = 0;  // RECOVER 模式下跳过的字节数
         std::chrono::system_clock::time_point first_timestamp;
         std::chrono::system_clock::time_point last_timestamp;
     };
 
+    // 映射内容在读取器生命周期内不变，统计结果只计算一次
     Statistics get_statistics() {
-        Statistics stats;
-        binary_file_.clear();
-        binary_file_.seekg(0, std::ios::beg);
+        if (statistics_) {
+            return *statistics_;
+        }
 
-        BinaryLogEntry header;
+        Statistics stats;
         bool first_record = true;
+        file_.advise_sequential();
 
-        while (binary_file_.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        auto all = records();
+        auto it = all.begin();
+        for (; it != all.end(); ++it) {
+            auto record = *it;
+            if (record.event_type() == ClockCalibrationRecord::TYPE_ID) {
+                stats.calibration_records++;
+                continue;
+            }
             stats.total_records++;
 
             auto timestamp = std::chrono::system_clock::time_point(
-                std::chrono::microseconds(header.timestamp_us));
+                std::chrono::microseconds(record.unix_us));
 
             if (first_record) {
                 stats.first_timestamp = timestamp;
@@ -113,8 +656,9 @@ public:
             }
             stats.last_timestamp = timestamp;
 
-            switch (header.event_type) {
+            switch (record.event_type()) {
                 case MarketDataRecord::TYPE_ID:
+                case FixedMarketDataRecord::TYPE_ID:
                     stats.market_data_records++;
                     break;
                 case OrderRecord::TYPE_ID:
@@ -127,86 +671,263 @@ public:
                     stats.unknown_records++;
                     break;
             }
-
-            // 跳过数据部分
-            binary_file_.seekg(header.data_size, std::ios::cur);
         }
 
-        return stats;
+        stats.resyncs = it.resyncs();
+        stats.skipped_bytes = it.skipped_bytes();
+
+        statistics_ = stats;
+        return *statistics_;
     }
 
 private:
-    void export_records(std::ofstream& csv_file, std::function<bool(uint32_t)> filter) {
-        binary_file_.clear();
-        binary_file_.seekg(0, std::ios::beg);
-
-        BinaryLogEntry header;
-        while (binary_file_.read(reinterpret_cast<char*>(&header), sizeof(header))) {
-            if (!filter(header.event_type)) {
-                binary_file_.seekg(header.data_size, std::ios::cur);
+    // 解压后的块，记录视图指向其中，存活到读取器析构
+    struct DecompressedBlock {
+        std::vector<char> bytes;
+        TscCalibration clock;
+    };
+
+    std::optional<Statistics> statistics_;
+    std::optional<BinaryLogTimeIndex> time_index_;
+    std::unordered_map<size_t, DecompressedBlock> blocks_;
+
+    // 记录所在的全部内存，压缩分段在首次调用时整体解压
+    std::span<const char> bytes() const {
+        if (compressed_ && decompressed_.empty() && compressed_->raw_size() > 0) {
+            decompressed_ = compressed_->read_all();
+            bytes_ = decompressed_;
+        }
+        return bytes_;
+    }
+
+    // 压缩分段的时间查询：由块索引定位起始块，逐块解压，直到块的首条记录不早于 end_us
+    // 同一微秒的记录可能跨块，起始块取首条记录早于 begin_us 的最后一块
+    std::vector<BinaryLogRecord> compressed_records_between(uint64_t begin_us,
+                                                            uint64_t end_us,
+                                                            std::optional<uint32_t> event_type) {
+        std::vector<BinaryLogRecord> result;
+        for (size_t i = compressed_->find_block_by_time(begin_us == 0 ? 0 : begin_us - 1);
+             i < compressed_->block_count() && compressed_->block(i).first_unix_us < end_us;
+             ++i) {
+            auto [it, inserted] = blocks_.try_emplace(i);
+            auto& block = it->second;
+            if (inserted) {
+                block.bytes = compressed_->read_block(i, &block.clock);
+            }
+
+            const char* end_ptr = block.bytes.data() + block.bytes.size();
+            BinaryLogIterator record_it(block.bytes.data(), end_ptr, block.clock, verify_);
+            for (BinaryLogIterator last(end_ptr, end_ptr); record_it != last; ++record_it) {
+                auto record = *record_it;
+                auto type = record.event_type();
+                if (type == ClockCalibrationRecord::TYPE_ID ||
+                    !matches_event_type(event_type, type) || record.unix_us < begin_us ||
+                    record.unix_us >= end_us) {
+                    continue;
+                }
+                result.push_back(record);
+            }
+        }
+        return result;
+    }
+
+    // 有新记录被索引时写回索引文件；写入失败（如只读目录）不影响本次查询
+    void update_time_index() {
+        if (time_index_->extend(bytes(), verify_)) {
+            time_index_->save(BinaryLogTimeIndex::sidecar_path(filename_));
+        }
+    }
+
+    static uint64_t to_microseconds(std::chrono::system_clock::time_point time) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count());
+    }
+
+    // 在记录边界处把文件切成约 chunk_bytes 的分块，分块起点的迭代器带有该处生效的时钟校准
+    // 只读取记录头部，远快于格式化
+    std::vector<BinaryLogIterator> partition(size_t chunk_bytes) const {
+        auto all = records();
+        std::vector<BinaryLogIterator> bounds;
+        const char* next_bound = bytes().data();
+        for (auto it = all.begin(); it != all.end(); ++it) {
+            const auto* pos = reinterpret_cast<const char*>((*it).header);
+            if (pos >= next_bound) {
+                bounds.push_back(it);
+                next_bound = pos + std::max<size_t>(chunk_bytes, 1);
+            }
+        }
+        bounds.push_back(all.end());
+        return bounds;
+    }
+
+    // 分块由工作线程用 format_to 格式化到各自的缓冲区，调用线程按分块顺序写出
+    // 同时在途的分块数有上限，缓冲区写出后回收复用
+    template <typename Filter>
+    void export_records(std::ofstream& csv_file, const Filter& filter) {
+        file_.advise_sequential();
+        auto bounds = partition(csv_config_.chunk_bytes);
+        size_t chunk_count = bounds.size() - 1;
+        size_t buffer_reserve = csv_config_.chunk_bytes * 2;  // CSV 行约为二进制记录的两倍长
+
+        size_t threads = csv_config_.threads != 0
+                             ? csv_config_.threads
+                             : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        threads = std::min(threads, chunk_count);
+
+        if (threads <= 1) {
+            std::string out;
+            out.reserve(buffer_reserve);
+            for (size_t i = 0; i < chunk_count; ++i) {
+                out.clear();
+                format_chunk(out, bounds[i], bounds[i + 1], filter);
+                csv_file.write(out.data(), static_cast<std::streamsize>(out.size()));
+            }
+            return;
+        }
+
+        const size_t window = threads * 2;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::string> chunks(chunk_count);
+        std::vector<bool> ready(chunk_count, false);
+        std::vector<std::string> free_buffers;
+        size_t next_chunk = 0;
+        size_t written = 0;
+
+        auto worker = [&] {
+            while (true) {
+                std::string out;
+                size_t index = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (next_chunk >= chunk_count) {
+                        return;
+                    }
+                    index = next_chunk++;
+                    cv.wait(lock, [&] { return index < written + window; });
+                    if (!free_buffers.empty()) {
+                        out = std::move(free_buffers.back());
+                        free_buffers.pop_back();
+                    }
+                }
+
+                out.clear();
+                out.reserve(buffer_reserve);
+                format_chunk(out, bounds[index], bounds[index + 1], filter);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    chunks[index] = std::move(out);
+                    ready[index] = true;
+                }
+                cv.notify_all();
+            }
+        };
+
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back(worker);
+        }
+
+        for (size_t i = 0; i < chunk_count; ++i) {
+            std::string out;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return ready[i]; });
+                out = std::move(chunks[i]);
+            }
+            csv_file.write(out.data(), static_cast<std::streamsize>(out.size()));
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                free_buffers.push_back(std::move(out));
+                written = i + 1;
+            }
+            cv.notify_all();
+        }
+    }
+
+    template <typename Filter>
+    void format_chunk(std::string& out,
+                      BinaryLogIterator it,
+                      const BinaryLogIterator& last,
+                      const Filter& filter) const {
+        for (; it != last; ++it) {
+            auto record = *it;
+            auto type = record.event_type();
+            if (type == ClockCalibrationRecord::TYPE_ID || !filter(type)) {
                 continue;
             }
 
-            switch (header.event_type) {
+            switch (type) {
                 case MarketDataRecord::TYPE_ID:
-                    export_market_data_record(csv_file, header);
+                case FixedMarketDataRecord::TYPE_ID:
+                    export_market_data_record(out, record);
                     break;
                 case OrderRecord::TYPE_ID:
-                    export_order_record(csv_file, header);
+                    export_order_record(out, record);
                     break;
                 case StrategySignalRecord::TYPE_ID:
-                    export_strategy_signal_record(csv_file, header);
+                    export_strategy_signal_record(out, record);
                     break;
                 default:
                     // 跳过未知类型
-                    binary_file_.seekg(header.data_size, std::ios::cur);
                     break;
             }
         }
     }
 
-    void write_csv_header(std::ofstream& csv, uint32_t event_type) {
+    void write_csv_header(std::ofstream& out, uint32_t event_type) {
         switch (event_type) {
             case MarketDataRecord::TYPE_ID:
-                csv << "timestamp,symbol,price,volume,side\n";
+            case FixedMarketDataRecord::TYPE_ID:
+                out << "timestamp,symbol,price,volume,side\n";
                 break;
             case OrderRecord::TYPE_ID:
-                csv << "timestamp,order_id,symbol,price,quantity,side,status\n";
+                out << "timestamp,order_id,symbol,price,quantity,side,status\n";
                 break;
             case StrategySignalRecord::TYPE_ID:
-                csv << "timestamp,strategy,symbol,signal_type,confidence,target_price,target_"
+                out << "timestamp,strategy,symbol,signal_type,confidence,target_price,target_"
                        "quantity\n";
                 break;
             default:
-                csv << "timestamp,event_type,raw_data\n";
+                out << "timestamp,event_type,raw_data\n";
                 break;
         }
     }
 
-    void export_market_data_record(std::ofstream& csv, const BinaryLogEntry& header) {
-        MarketDataRecord record;
-        binary_file_.read(reinterpret_cast<char*>(&record), sizeof(record));
+    void export_market_data_record(std::string& out, const BinaryLogRecord& entry) const {
+        auto record = entry.market_data();
+        if (!record) {
+            return;
+        }
 
-        auto time_str = format_timestamp(header.timestamp_us);
-        auto symbol = get_symbol_name(record.symbol_id);
-        auto side = record.side == 0 ? "BUY" : "SELL";
+        const auto& symbol = get_symbol_name(record->symbol_id);
+        auto side = record->side == 0 ? "BUY" : "SELL";
 
         // 复制packed字段值避免引用绑定问题
-        double price = record.price;
-        uint64_t volume = record.volume;
-        csv << std::format("{},{},{:.6f},{},{}\n", time_str, symbol, price, volume, side);
+        double price = record->price;
+        uint64_t volume = record->volume;
+        format_timestamp(out, entry.unix_us);
+        std::format_to(std::back_inserter(out),
+                       ",{},{:.6f},{},{}\n",
+                       symbol,
+                       price,
+                       volume,
+                       side);
     }
 
-    void export_order_record(std::ofstream& csv, const BinaryLogEntry& header) {
-        OrderRecord record;
-        binary_file_.read(reinterpret_cast<char*>(&record), sizeof(record));
+    void export_order_record(std::string& out, const BinaryLogRecord& entry) const {
+        auto record = entry.as<OrderRecord>();
+        if (!record) {
+            return;
+        }
 
-        auto time_str = format_timestamp(header.timestamp_us);
-        auto symbol = get_symbol_name(record.symbol_id);
-        auto side = record.side == 0 ? "BUY" : "SELL";
+        const auto& symbol = get_symbol_name(record->symbol_id);
+        auto side = record->side == 0 ? "BUY" : "SELL";
 
-        std::string status;
-        switch (record.status) {
+        const char* status;
+        switch (record->status) {
             case 0:
                 status = "NEW";
                 break;
@@ -222,29 +943,31 @@ private:
         }
 
         // 复制packed字段值避免引用绑定问题
-        uint64_t order_id = record.order_id;
-        double price = record.price;
-        uint32_t quantity = record.quantity;
-        csv << std::format("{},{},{},{:.6f},{},{},{}\n",
-                           time_str,
-                           order_id,
-                           symbol,
-                           price,
-                           quantity,
-                           side,
-                           status);
-    }
-
-    void export_strategy_signal_record(std::ofstream& csv, const BinaryLogEntry& header) {
-        StrategySignalRecord record;
-        binary_file_.read(reinterpret_cast<char*>(&record), sizeof(record));
-
-        auto time_str = format_timestamp(header.timestamp_us);
-        auto strategy = get_strategy_name(record.strategy_id);
-        auto symbol = get_symbol_name(record.symbol_id);
-
-        std::string signal_type;
-        switch (record.signal_type) {
+        uint64_t order_id = record->order_id;
+        double price = record->price;
+        uint32_t quantity = record->quantity;
+        format_timestamp(out, entry.unix_us);
+        std::format_to(std::back_inserter(out),
+                       ",{},{},{:.6f},{},{},{}\n",
+                       order_id,
+                       symbol,
+                       price,
+                       quantity,
+                       side,
+                       status);
+    }
+
+    void export_strategy_signal_record(std::string& out, const BinaryLogRecord& entry) const {
+        auto record = entry.as<StrategySignalRecord>();
+        if (!record) {
+            return;
+        }
+
+        const auto& strategy = get_strategy_name(record->strategy_id);
+        const auto& symbol = get_symbol_name(record->symbol_id);
+
+        const char* signal_type;
+        switch (record->signal_type) {
             case 0:
                 signal_type = "BUY";
                 break;
@@ -260,41 +983,54 @@ private:
         }
 
         // 复制packed字段值避免引用绑定问题
-        uint8_t confidence = record.confidence;
-        double target_price = record.target_price;
-        uint32_t target_quantity = record.target_quantity;
-        csv << std::format("{},{},{},{},{},{:.6f},{}\n",
-                           time_str,
-                           strategy,
-                           symbol,
-                           signal_type,
-                           confidence,
-                           target_price,
-                           target_quantity);
-    }
-
-    std::string format_timestamp(uint64_t timestamp_us) {
-        auto time_point =
-            std::chrono::system_clock::time_point(std::chrono::microseconds(timestamp_us));
-        auto time_t = std::chrono::system_clock::to_time_t(time_point);
-        auto microsec = timestamp_us % 1000000;
-
-        return std::format("{:%Y-%m-%d %H:%M:%S}.{:06d}",
-                           std::chrono::system_clock::from_time_t(time_t),
-                           microsec);
-    }
-
-    const std::string& get_symbol_name(uint32_t symbol_id) {
+        uint8_t confidence = record->confidence;
+        double target_price = record->target_price;
+        uint32_t target_quantity = record->target_quantity;
+        format_timestamp(out, entry.unix_us);
+        std::format_to(std::back_inserter(out),
+                       ",{},{},{},{},{:.6f},{}\n",
+                       strategy,
+                       symbol,
+                       signal_type,
+                       confidence,
+                       target_price,
+                       target_quantity);
+    }
+
+    // UTC 时间 "YYYY-MM-DD HH:MM:SS.ffffff"，直接写入输出缓冲区
+    static void format_timestamp(std::string& out, uint64_t timestamp_us) {
+        using namespace std::chrono;
+        sys_time<microseconds> time_point{microseconds(timestamp_us)};
+        auto day = floor<days>(time_point);
+        year_month_day date{day};
+        hh_mm_ss time{time_point - day};
+
+        std::format_to(std::back_inserter(out),
+                       "{:04d}-{:02d}-{:02d} {:02d}:{:02d}:{:02d}.{:06d}",
+                       static_cast<int>(date.year()),
+                       static_cast<unsigned>(date.month()),
+                       static_cast<unsigned>(date.day()),
+                       time.hours().count(),
+                       time.minutes().count(),
+                       time.seconds().count(),
+                       time.subseconds().count());
+    }
+
+    const std::string& get_symbol_name(SymbolId symbol_id) const {
         static const std::string unknown = "UNKNOWN";
-        auto it = symbol_map_.find(symbol_id);
-        return it != symbol_map_.end() ? it->second : unknown;
+        const auto& name = symbols_->name(symbol_id);
+        return name.empty() ? unknown : name;
     }
 
-    const std::string& get_strategy_name(uint32_t strategy_id) {
+    const std::string& get_strategy_name(uint32_t strategy_id) const {
         static const std::string unknown = "UNKNOWN";
         auto it = strategy_map_.find(strategy_id);
         return it != strategy_map_.end() ? it->second : unknown;
     }
 };
 
-}  // namespace cppshares::utils
\ No newline at end of file
+}  // namespace cppshares::utils
+
+// 记录视图指向映射内存而非区间对象本身
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<cppshares::utils::BinaryLogRecords> = true;
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "tsc_clock.hpp"
+
+namespace cppshares::utils {
+
+// 二进制日志分段参数；max_segment_bytes 与 max_segment_age 均为 0 时不分段，始终追加到同一文件
+struct SegmentConfig {
+    uint64_t max_segment_bytes = 0;           // 分段大小上限
+    std::chrono::seconds max_segment_age{0};  // 分段时长上限
+    bool compress_closed = false;             // 后台压缩已关闭的分段
+    size_t block_size = 1024 * 1024;          // 压缩块的原始大小（在记录边界处切分）
+    int compression_level = 1;                // zlib 压缩级别，默认取最快
+
+    bool enabled() const { return max_segment_bytes > 0 || max_segment_age.count() > 0; }
+};
+
+// 分段状态
+enum class SegmentState { OPEN, CLOSED, COMPRESSED };
+
+// 清单中的一个分段
+struct SegmentInfo {
+    std::string file;  // 分段文件名（与清单位于同一目录）
+    uint64_t opened_unix_us = 0;
+    uint64_t closed_unix_us = 0;
+    uint64_t raw_bytes = 0;
+    SegmentState state = SegmentState::OPEN;
+};
+
+// 分段管理：分段命名为 <日志名>.<序号>.bin，压缩后为 .binz，清单为 <日志名>.manifest
+// 清单为 CSV 文本，每次变更整体改写（先写临时文件再改名）
+class BinaryLogSegments {
+public:
+    BinaryLogSegments(const std::string& base_path, SegmentConfig config);
+    ~BinaryLogSegments();
+
+    BinaryLogSegments(const BinaryLogSegments&) = delete;
+    BinaryLogSegments& operator=(const BinaryLogSegments&) = delete;
+
+    // 开始一个新分段，返回其路径
+    std::string open_next();
+
+    // 关闭当前分段；开启压缩时交给后台线程
+    void close_current(uint64_t raw_bytes);
+
+    // 阻塞直到已提交的压缩任务全部完成
+    void wait_for_compression();
+
+    const SegmentConfig& config() const { return config_; }
+
+    std::vector<SegmentInfo> segments() const;
+
+    static std::string manifest_path(const std::string& base_path);
+    // 读取清单；清单不存在时返回空
+    static std::vector<SegmentInfo> read_manifest(const std::string& base_path);
+
+private:
+    void run_compressor();
+    void write_manifest() const;  // 调用方需持有 mutex_
+    std::string segment_path(const std::string& file) const;
+
+    std::string directory_;
+    std::string stem_;
+    std::string base_path_;
+    SegmentConfig config_;
+    uint64_t next_index_ = 1;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::vector<SegmentInfo> segments_;
+    std::deque<size_t> pending_;  // 待压缩分段在 segments_ 中的下标
+    bool compressing_ = false;
+    bool stopping_ = false;
+    std::thread compressor_;
+};
+
+// 压缩分段格式：文件头魔数，随后是若干块（块头 + zlib 数据），最后是块索引与文件尾
+// 块总在记录边界处切分，并带有块起点生效的时钟校准，因此每块可以单独解压和解析
+inline constexpr char COMPRESSED_LOG_MAGIC[8] = {'C', 'P', 'S', 'B', 'L', 'Z', '0', '1'};
+
+struct CompressedBlockHeader {
+    uint32_t raw_size;         // 解压后大小
+    uint32_t stored_size;      // 压缩数据大小
+    uint64_t reference_ticks;  // 块起点生效的时钟校准
+    int64_t reference_unix_ns;
+    double ns_per_tick;
+} __attribute__((packed));
+
+struct CompressedBlockIndexEntry {
+    uint64_t file_offset;    // 块头在压缩文件中的偏移
+    uint64_t raw_offset;     // 块在原始分段中的偏移
+    uint64_t first_unix_us;  // 块内第一条记录的时间戳
+} __attribute__((packed));
+
+struct CompressedLogFooter {
+    uint64_t index_offset;
+    uint64_t block_count;
+    uint64_t raw_size;
+    char magic[8];
+} __attribute__((packed));
+
+bool is_compressed_log(std::span<const char> bytes);
+
+// 把原始分段压缩为块格式，返回块数；压缩块达到 block_size 后在下一个块标记处结束
+size_t compress_segment(const std::string& source,
+                        const std::string& destination,
+                        size_t block_size,
+                        int level);
+
+// 压缩分段读取：按块解压，可按原始偏移或时间定位到块
+class CompressedLogReader {
+public:
+    explicit CompressedLogReader(const std::string& path);
+
+    size_t block_count() const { return index_.size(); }
+    const CompressedBlockIndexEntry& block(size_t index) const { return index_[index]; }
+    uint64_t raw_size() const { return raw_size_; }
+
+    // 解压一块；clock 非空时写入块起点生效的时钟校准
+    std::vector<char> read_block(size_t index, TscCalibration* clock = nullptr) const;
+
+    // 包含 unix_us 时刻的块：首条记录时间不晚于 unix_us 的最后一块
+    size_t find_block_by_time(uint64_t unix_us) const;
+    // 包含原始偏移 raw_offset 的块
+    size_t find_block_by_offset(uint64_t raw_offset) const;
+
+    // 解压整个分段
+    std::vector<char> read_all() const;
+
+private:
+    MappedFile file_;
+    std::span<const CompressedBlockIndexEntry> index_;
+    uint64_t raw_size_ = 0;
+};
+
+}  // namespace cppshares::utils
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "binary_log_reader.hpp"
+#include "mapped_file.hpp"
+
+namespace cppshares::utils {
+
+// 列式文件：文件头 + 列描述表 + 各列连续数组（按 64 字节对齐，小端）
+// numpy 读取：np.memmap(path, dtype=<列类型>, mode="r", offset=desc.offset, shape=(row_count,))
+inline constexpr char COLUMNAR_FILE_MAGIC[8] = {'C', 'P', 'S', 'C', 'O', 'L', '0', '1'};
+inline constexpr size_t COLUMN_ALIGNMENT = 64;
+
+// 列元素类型，括号内为对应的 numpy dtype
+enum class ColumnType : uint8_t {
+    U8 = 1,   // uint8
+    U32 = 2,  // uint32
+    U64 = 3,  // uint64
+    I64 = 4,  // int64
+    F64 = 5   // float64
+};
+
+enum class ColumnEncoding : uint8_t {
+    PLAIN = 0,
+    DELTA = 1  // 首个元素为原值，其后为与前一元素的差值，np.cumsum 即可还原
+};
+
+struct ColumnarFileHeader {
+    char magic[8];
+    uint32_t event_type;    // 对应的二进制日志记录类型
+    uint32_t column_count;  // 其后紧跟 column_count 个 ColumnDescriptor
+    uint64_t row_count;
+} __attribute__((packed));
+
+struct ColumnDescriptor {
+    char name[24];  // 以 '\0' 结尾的列名
+    ColumnType type;
+    ColumnEncoding encoding;
+    uint8_t reserved[6];
+    uint64_t offset;  // 列数组在文件中的偏移
+    uint64_t size;    // 列数组字节数
+} __attribute__((packed));
+
+// 列式导出参数
+struct ColumnarExportConfig {
+    bool delta_timestamps = true;  // timestamp_us 列按 DELTA 编码（int64）
+};
+
+// 按记录类型把二进制日志导出为列式文件：
+//   market_data.col       timestamp_us, symbol_id, price, volume, side（含定点行情记录）
+//   orders.col            timestamp_us, order_id, symbol_id, price, quantity, side, status
+//   strategy_signals.col  timestamp_us, strategy_id, symbol_id, signal_type, confidence,
+//                         target_price, target_quantity
+// 先统计各类型行数，再直接写入预先分配好大小的映射文件，不在内存中缓存整列
+class ColumnarExporter {
+public:
+    explicit ColumnarExporter(ColumnarExportConfig config = {}) : config_(config) {}
+
+    // 导出到目录，返回各文件的路径
+    std::vector<std::string> export_all(BinaryLogReader& reader,
+                                        const std::string& directory) const;
+
+private:
+    ColumnarExportConfig config_;
+};
+
+// 列式文件读取：整文件只读映射，PLAIN 列直接以 span 访问
+class ColumnarFile {
+public:
+    explicit ColumnarFile(const std::string& path);
+
+    uint32_t event_type() const { return header().event_type; }
+    uint64_t row_count() const { return header().row_count; }
+    std::span<const ColumnDescriptor> columns() const;
+
+    // 列描述，不存在时返回 nullptr
+    const ColumnDescriptor* find_column(std::string_view name) const;
+
+    // 列数组的零拷贝视图；列不存在或类型不符时抛出异常
+    template <typename T>
+    std::span<const T> column(std::string_view name) const {
+        const auto* desc = find_column(name);
+        if (desc == nullptr || desc->type != column_type_of<T>()) {
+            throw std::runtime_error("Column not found or type mismatch: " + std::string(name));
+        }
+        return {reinterpret_cast<const T*>(file_.data() + desc->offset), row_count()};
+    }
+
+    // 还原后的时间戳（unix 微秒），DELTA 编码时做前缀和
+    std::vector<uint64_t> timestamps() const;
+
+    template <typename T>
+    static constexpr ColumnType column_type_of() {
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            return ColumnType::U8;
+        } else if constexpr (std::is_same_v<T, uint32_t>) {
+            return ColumnType::U32;
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            return ColumnType::U64;
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            return ColumnType::I64;
+        } else {
+            static_assert(std::is_same_v<T, double>, "unsupported column type");
+            return ColumnType::F64;
+        }
+    }
+
+private:
+    const ColumnarFileHeader& header() const {
+        return *reinterpret_cast<const ColumnarFileHeader*>(file_.data());
+    }
+
+    MappedFile file_;
+};
+
+}  // namespace cppshares::utils
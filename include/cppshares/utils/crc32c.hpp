@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cppshares::utils {
+
+// CRC32C（Castagnoli 多项式）；x86 SSE4.2 或 ARMv8 CRC 指令可用时使用硬件指令，否则查表
+// crc 为前一段数据的结果，可分段计算
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+}  // namespace cppshares::utils
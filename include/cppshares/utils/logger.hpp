@@ -6,24 +6,69 @@
 #include <spdlog/spdlog.h>
 
 #include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "binary_log_segment.hpp"
+#include "crc32c.hpp"
+#include "price.hpp"
+#include "response_capture.hpp"
+#include "symbol_registry.hpp"
+#include "tsc_clock.hpp"
+
 namespace cppshares::utils {
 
 // 二进制日志记录头部
 struct BinaryLogEntry {
-    uint64_t timestamp_us;  // 8字节 - 微秒级时间戳
+    uint64_t timestamp_us;  // 8字节 - 微秒级时间戳；TSC 模式下为周期计数，见 ClockCalibrationRecord
     uint32_t event_type;    // 4字节 - 事件类型ID
     uint32_t data_size;     // 4字节 - 数据部分大小
     // 后续跟随变长数据部分
 } __attribute__((packed));
 
+// 时钟校准记录：之后各记录的时间戳按最近一条校准记录换算
+// ns_per_tick 为 0 表示时间戳是 system_clock 微秒；没有校准记录的旧日志也按微秒解释
+struct ClockCalibrationRecord {
+    static constexpr uint32_t TYPE_ID = 0x0001;
+
+    uint64_t reference_ticks;   // 8字节 - 校准时刻的周期计数
+    int64_t reference_unix_ns;  // 8字节 - 同一时刻的 system_clock 纳秒
+    double ns_per_tick;         // 8字节 - 每个计数对应的纳秒数
+} __attribute__((packed));
+
+// 文件头记录：新建的日志文件（或分段）以它开头，没有文件头的旧日志不做块校验
+inline constexpr char BINARY_LOG_FILE_MAGIC[8] = {'C', 'P', 'S', 'B', 'L', 'O', 'G', '1'};
+inline constexpr uint32_t BINARY_LOG_FORMAT_VERSION = 1;
+
+struct LogFileHeaderRecord {
+    static constexpr uint32_t TYPE_ID = 0x0002;
+
+    char magic[8];     // 8字节 - BINARY_LOG_FILE_MAGIC
+    uint32_t version;  // 4字节 - 格式版本
+    uint32_t flags;    // 4字节 - 保留
+} __attribute__((packed));
+
+// 块标记记录：每次落盘的缓冲区前写入一条，覆盖其后 block_size 字节的完整记录
+// 恢复模式下读取端校验 CRC，损坏时在下一个块标记处重新同步
+inline constexpr char BINARY_LOG_BLOCK_MAGIC[8] = {'C', 'P', 'S', 'B', 'L', 'K', '0', '1'};
+
+struct BlockMarkerRecord {
+    static constexpr uint32_t TYPE_ID = 0x0003;
+
+    char magic[8];        // 8字节 - BINARY_LOG_BLOCK_MAGIC
+    uint32_t block_size;  // 4字节 - 块内记录的总字节数
+    uint32_t crc;         // 4字节 - 块内记录的 CRC32C
+} __attribute__((packed));
+
 // 市场数据记录
 struct MarketDataRecord {
     static constexpr uint32_t TYPE_ID = 0x1001;
@@ -35,6 +80,18 @@ struct MarketDataRecord {
     uint8_t padding[3];  // 3字节 - 内存对齐填充
 } __attribute__((packed));
 
+// 定点行情记录：价格为 Price 原始值（0.0001），记录体为 MarketDataRecord 的三分之二
+// 价格或成交量超出 32 位范围时 HybridLogger 改写 MarketDataRecord
+struct FixedMarketDataRecord {
+    static constexpr uint32_t TYPE_ID = 0x1002;
+
+    uint32_t symbol_id;  // 4字节 - 符号ID
+    int32_t price;       // 4字节 - Price::raw()，上限约 21.47 万
+    uint32_t volume;     // 4字节 - 成交量
+    uint8_t side;        // 1字节 - 买卖方向 0=买 1=卖
+    uint8_t padding[3];  // 3字节 - 内存对齐填充
+} __attribute__((packed));
+
 // 订单记录
 struct OrderRecord {
     static constexpr uint32_t TYPE_ID = 0x2001;
@@ -121,46 +178,195 @@ private:
 using binary_sink_mt = binary_sink<std::mutex>;
 using binary_sink_st = binary_sink<spdlog::details::null_mutex>;
 
+// 异步模式下环形缓冲区写满时的处理策略
+enum class BackpressurePolicy {
+    BLOCK,  // 生产者让出CPU直到有空槽位，不丢记录
+    DROP    // 立即丢弃新记录并计数
+};
+
+// 二进制日志时间戳来源
+enum class TimestampSource {
+    SYSTEM_CLOCK,  // 每条记录读取 system_clock 并换算为微秒
+    TSC            // 每条记录只读周期计数器，由读取端按校准记录换算
+};
+
+// 异步二进制日志参数
+struct AsyncLogConfig {
+    size_t ring_capacity = 1 << 16;  // 槽位数，向上取整为2的幂
+    BackpressurePolicy backpressure = BackpressurePolicy::DROP;
+    std::chrono::microseconds idle_sleep{200};  // 缓冲区为空时刷盘线程的休眠间隔
+};
+
 // 纯二进制日志器
+// 同步模式下写入线程持锁写缓冲区；异步模式下写入线程只把记录放入无锁 MPSC 环形缓冲区，
+// 由后台刷盘线程批量写入文件，写入路径上没有锁与系统调用；
+// 放不进环形缓冲区槽位的大记录在异步模式下也走持锁的同步写入
 class BinaryLogger {
 private:
     std::ofstream binary_file_;
-    std::mutex write_mutex_;
+    std::mutex write_mutex_;  // 保护写缓冲区与文件，异步模式下由刷盘线程与大记录的写入共用
     static constexpr size_t BUFFER_SIZE = 64 * 1024;  // 64KB缓冲区
     std::vector<char> write_buffer_;
     size_t buffer_pos_ = 0;
 
+    // 异步模式：Vyukov 有界队列，槽位序号标记槽位可写/可读
+    struct alignas(64) Slot {
+        static constexpr size_t PAYLOAD_SIZE = 64 - sizeof(std::atomic<uint64_t>) - sizeof(uint32_t);
+
+        std::atomic<uint64_t> sequence{0};
+        uint32_t size = 0;
+        char payload[PAYLOAD_SIZE];
+    };
+
+    bool async_ = false;
+    AsyncLogConfig async_config_;
+    std::unique_ptr<Slot[]> ring_;
+    size_t ring_mask_ = 0;
+    alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+    alignas(64) uint64_t dequeue_pos_ = 0;  // 由 write_mutex_ 保护
+    std::atomic<size_t> dropped_{0};
+    std::atomic<size_t> blocked_{0};
+
+    std::mutex flush_mutex_;
+    std::condition_variable flushed_;
+    uint64_t flushed_pos_ = 0;  // 已写入文件的记录位置，由 flush_mutex_ 保护
+    std::atomic<bool> flush_requested_{false};
+    std::atomic<bool> stopping_{false};
+    std::thread flusher_;
+
+    // TSC 时间戳：定期写入校准记录，同步模式由写入线程在持锁时检查，异步模式由刷盘线程检查
+    TimestampSource timestamp_source_ = TimestampSource::SYSTEM_CLOCK;
+    std::unique_ptr<TscCalibrator> calibrator_;
+    uint64_t recalibration_ticks_ = 0;
+    uint64_t next_calibration_ticks_ = 0;
+
+    static constexpr auto RECALIBRATION_INTERVAL = std::chrono::seconds(1);
+
+    // 分段：同步模式由写入线程在持锁时检查，异步模式由刷盘线程检查
+    std::unique_ptr<BinaryLogSegments> segments_;
+    uint64_t segment_bytes_ = 0;              // 当前分段已写入文件的字节数
+    uint64_t segment_deadline_ = UINT64_MAX;  // 按时间切换分段的时刻，与记录时间戳同单位
+
 public:
-    explicit BinaryLogger(const std::string& filename)
-        : binary_file_(filename, std::ios::binary | std::ios::app), write_buffer_(BUFFER_SIZE) {}
+    // 同步模式；segments 启用时 filename 作为分段名的基础，记录写入 <日志名>.<序号>.bin
+    explicit BinaryLogger(const std::string& filename,
+                          TimestampSource timestamp_source = TimestampSource::SYSTEM_CLOCK,
+                          SegmentConfig segments = {});
 
-    ~BinaryLogger() { flush_buffer(); }
+    // 异步模式
+    BinaryLogger(const std::string& filename,
+                 AsyncLogConfig config,
+                 TimestampSource timestamp_source = TimestampSource::SYSTEM_CLOCK,
+                 SegmentConfig segments = {});
+
+    ~BinaryLogger();
 
     template <typename RecordType>
     void log_binary(const RecordType& record) {
-        BinaryLogEntry header{.timestamp_us = static_cast<uint64_t>(
-                                  std::chrono::duration_cast<std::chrono::microseconds>(
-                                      std::chrono::high_resolution_clock::now().time_since_epoch())
-                                      .count()),
+        BinaryLogEntry header{.timestamp_us = current_timestamp(),
                               .event_type = RecordType::TYPE_ID,
                               .data_size = sizeof(RecordType)};
 
-        std::lock_guard<std::mutex> lock(write_mutex_);
+        if constexpr (sizeof(BinaryLogEntry) + sizeof(RecordType) <= Slot::PAYLOAD_SIZE) {
+            if (async_) {
+                enqueue(header, &record, sizeof(record));
+                return;
+            }
+        }
+        write_locked(header, &record, sizeof(record));
+    }
 
-        write_to_buffer(reinterpret_cast<const char*>(&header), sizeof(header));
-        write_to_buffer(reinterpret_cast<const char*>(&record), sizeof(record));
+    // 异步模式下阻塞直到调用前写入的记录全部落盘
+    void flush();
 
-        if (buffer_pos_ > BUFFER_SIZE - 1024) {
-            flush_buffer();
+    // 分段模式下的分段管理器，未分段时为空
+    BinaryLogSegments* segments() const { return segments_.get(); }
+
+    struct Statistics {
+        size_t dropped = 0;  // 因缓冲区满被丢弃的记录数（DROP 策略）
+        size_t blocked = 0;  // 因缓冲区满而等待的写入次数（BLOCK 策略）
+    };
+    Statistics get_statistics() const {
+        return {.dropped = dropped_.load(std::memory_order_relaxed),
+                .blocked = blocked_.load(std::memory_order_relaxed)};
+    }
+
+private:
+    uint64_t current_timestamp() const {
+        if (timestamp_source_ == TimestampSource::TSC) {
+            return read_cycle_counter();
         }
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
     }
 
-    void flush() {
-        std::lock_guard<std::mutex> lock(write_mutex_);
-        flush_buffer();
+    // 写入校准记录，调用方需独占 write_buffer_
+    void write_calibration();
+
+    // 持锁写入一条记录：同步模式的写入路径，异步模式下用于放不进槽位的记录
+    void write_locked(const BinaryLogEntry& header, const void* record, size_t record_size);
+
+    bool segment_due(uint64_t timestamp) const {
+        uint64_t max_bytes = segments_->config().max_segment_bytes;
+        if (max_bytes > 0 && segment_bytes_ + buffer_pos_ >= max_bytes) {
+            return true;
+        }
+        return timestamp >= segment_deadline_;
     }
 
-private:
+    // 打开日志文件，新文件先写入文件头
+    void open_file(const std::string& path);
+    // 打开新分段并写入校准记录，调用方需独占 write_buffer_
+    void open_segment();
+    // 关闭当前分段并切换到新分段
+    void rotate_segment();
+
+    void enqueue(const BinaryLogEntry& header, const void* record, size_t record_size) {
+        bool waited = false;
+        while (!try_enqueue(header, record, record_size)) {
+            if (async_config_.backpressure == BackpressurePolicy::DROP) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (!waited) {
+                blocked_.fetch_add(1, std::memory_order_relaxed);
+                waited = true;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    bool try_enqueue(const BinaryLogEntry& header, const void* record, size_t record_size) {
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &ring_[pos & ring_mask_];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 槽位尚未被刷盘线程取走，缓冲区已满
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::memcpy(slot->payload, &header, sizeof(header));
+        std::memcpy(slot->payload + sizeof(header), record, record_size);
+        slot->size = static_cast<uint32_t>(sizeof(header) + record_size);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    void run_flusher();
+    size_t drain();
+
+    // 缓冲区只在记录边界处落盘，保证每个块只包含完整记录
     void write_to_buffer(const char* data, size_t size) {
         if (buffer_pos_ + size > BUFFER_SIZE) {
             flush_buffer();
@@ -169,10 +375,31 @@ private:
         buffer_pos_ += size;
     }
 
+    void write_record_to_buffer(const BinaryLogEntry& header, const void* record, size_t size) {
+        if (buffer_pos_ + sizeof(header) + size > BUFFER_SIZE) {
+            flush_buffer();
+        }
+        std::memcpy(write_buffer_.data() + buffer_pos_, &header, sizeof(header));
+        std::memcpy(write_buffer_.data() + buffer_pos_ + sizeof(header), record, size);
+        buffer_pos_ += sizeof(header) + size;
+    }
+
+    // 缓冲区作为一个块写出，前面加上块标记
     void flush_buffer() {
         if (buffer_pos_ > 0) {
+            BinaryLogEntry header{.timestamp_us = 0,
+                                  .event_type = BlockMarkerRecord::TYPE_ID,
+                                  .data_size = sizeof(BlockMarkerRecord)};
+            BlockMarkerRecord marker{};
+            std::memcpy(marker.magic, BINARY_LOG_BLOCK_MAGIC, sizeof(marker.magic));
+            marker.block_size = static_cast<uint32_t>(buffer_pos_);
+            marker.crc = crc32c(write_buffer_.data(), buffer_pos_);
+
+            binary_file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            binary_file_.write(reinterpret_cast<const char*>(&marker), sizeof(marker));
             binary_file_.write(write_buffer_.data(), buffer_pos_);
             binary_file_.flush();
+            segment_bytes_ += sizeof(header) + sizeof(marker) + buffer_pos_;
             buffer_pos_ = 0;
         }
     }
@@ -183,11 +410,14 @@ class HybridLogger {
 private:
     std::shared_ptr<spdlog::logger> text_logger_;
     std::unique_ptr<BinaryLogger> binary_logger_;
-    std::unordered_map<uint32_t, std::string> symbol_map_;
+    SymbolRegistry* symbols_ = &SymbolRegistry::global();
 
 public:
+    // async_binary 非空时二进制日志使用异步模式；binary_segments 控制二进制日志分段与压缩
     HybridLogger(const std::string& text_log_path = "logs/system.log",
-                 const std::string& binary_log_path = "logs/market_data.bin") {
+                 const std::string& binary_log_path = "logs/market_data.bin",
+                 std::optional<AsyncLogConfig> async_binary = std::nullopt,
+                 SegmentConfig binary_segments = {}) {
         // 创建文本日志器（spdlog）
         auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
         auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
@@ -199,7 +429,13 @@ public:
         text_logger_->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%n] %v");
 
         // 创建二进制日志器
-        binary_logger_ = std::make_unique<BinaryLogger>(binary_log_path);
+        if (async_binary) {
+            binary_logger_ = std::make_unique<BinaryLogger>(
+                binary_log_path, *async_binary, TimestampSource::SYSTEM_CLOCK, binary_segments);
+        } else {
+            binary_logger_ = std::make_unique<BinaryLogger>(
+                binary_log_path, TimestampSource::SYSTEM_CLOCK, binary_segments);
+        }
     }
 
     // 文本日志接口（委托给spdlog）
@@ -239,6 +475,20 @@ public:
         log_data(record);
     }
 
+    // 便利方法：以定点价格记录市场数据，能放入 FixedMarketDataRecord 时使用紧凑格式
+    void log_market_data(uint32_t symbol_id, Price price, uint64_t volume, bool is_buy) {
+        if (price.raw() < INT32_MIN || price.raw() > INT32_MAX || volume > UINT32_MAX) {
+            log_market_data(symbol_id, price.to_double(), volume, is_buy);
+            return;
+        }
+        FixedMarketDataRecord record{.symbol_id = symbol_id,
+                                     .price = static_cast<int32_t>(price.raw()),
+                                     .volume = static_cast<uint32_t>(volume),
+                                     .side = static_cast<uint8_t>(is_buy ? 0 : 1),
+                                     .padding = {0, 0, 0}};
+        log_data(record);
+    }
+
     // 便利方法：记录订单
     void log_order(uint64_t order_id,
                    uint32_t symbol_id,
@@ -278,15 +528,18 @@ public:
         binary_logger_->flush();
     }
 
-    // 符号映射管理
-    void register_symbol(uint32_t symbol_id, const std::string& symbol) {
-        symbol_map_[symbol_id] = symbol;
-    }
+    // 符号映射：记录中的 symbol_id 即全局注册表中的 id
+    SymbolId intern_symbol(std::string_view symbol) { return symbols_->intern(symbol); }
 
-    const std::string& get_symbol_name(uint32_t symbol_id) const {
+    const std::string& get_symbol_name(SymbolId symbol_id) const {
         static const std::string unknown = "UNKNOWN";
-        auto it = symbol_map_.find(symbol_id);
-        return it != symbol_map_.end() ? it->second : unknown;
+        const auto& name = symbols_->name(symbol_id);
+        return name.empty() ? unknown : name;
+    }
+
+    // 写出符号映射文件，供其他进程读取本日志时加载
+    bool save_symbol_map(const std::string& symbol_file) const {
+        return symbols_->save(symbol_file);
     }
 };
 
@@ -299,10 +552,12 @@ public:
     }
 
     static void initialize(const std::string& text_log_path = "logs/system.log",
-                           const std::string& binary_log_path = "logs/market_data.bin") {
+                           const std::string& binary_log_path = "logs/market_data.bin",
+                           std::optional<AsyncLogConfig> async_binary = std::nullopt,
+                           SegmentConfig binary_segments = {}) {
         // 创建日志目录
         std::filesystem::create_directories("logs");
-        instance() = HybridLogger(text_log_path, binary_log_path);
+        instance() = HybridLogger(text_log_path, binary_log_path, async_binary, binary_segments);
     }
 
     // 静态便利方法
@@ -321,11 +576,15 @@ public:
         instance().log_data(record);
     }
 
-    // JSON 响应日志方法
-    static void log_json_response(const std::string& provider_name,
-                                  const std::string& operation_type,
-                                  const std::string& symbol,
-                                  const std::string& json_response);
+    // 上游响应采集：按采样率入队，由后台线程追加写入采集档案
+    static void capture_response(std::string_view provider_name,
+                                 std::string_view operation_type,
+                                 std::string_view symbol,
+                                 std::string_view response,
+                                 bool error = false);
+
+    // 替换采集参数，之前已入队的响应写入旧档案后才切换
+    static void configure_capture(const CaptureConfig& config);
 
     template <typename... Args>
     static void debug(spdlog::format_string_t<Args...> fmt, Args&&... args) {
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace cppshares::utils {
+
+// 内存映射文件：默认只读映射，映射的是打开时刻的文件大小，之后追加的内容不可见
+class MappedFile {
+public:
+    // 新建（或截断）文件并以可写方式映射 size 字节
+    static MappedFile create(const std::string& path, size_t size) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create file: " + path);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to resize file: " + path);
+        }
+
+        MappedFile file;
+        file.size_ = size;
+        if (size > 0) {
+            void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            file.data_ = static_cast<const char*>(addr);
+            file.writable_ = true;
+        }
+        ::close(fd);
+        return file;
+    }
+
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat file: " + path);
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            data_ = static_cast<const char*>(addr);
+        }
+        // 映射建立后即可关闭描述符
+        ::close(fd);
+    }
+
+    ~MappedFile() { unmap(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          writable_(std::exchange(other.writable_, false)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            writable_ = std::exchange(other.writable_, false);
+        }
+        return *this;
+    }
+
+    // 提示内核按顺序预读，适合整文件扫描
+    void advise_sequential() const {
+        if (data_ != nullptr) {
+            ::madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+        }
+    }
+
+    std::span<const char> bytes() const { return {data_, size_}; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // 仅 create() 建立的映射可写
+    char* mutable_data() { return writable_ ? const_cast<char*>(data_) : nullptr; }
+
+private:
+    MappedFile() = default;
+
+    void unmap() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+            data_ = nullptr;
+        }
+    }
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool writable_ = false;
+};
+
+}  // namespace cppshares::utils
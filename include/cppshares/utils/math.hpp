@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <span>
 #include <vector>
 
 namespace cppshares::utils {
@@ -24,7 +25,7 @@ static inline double calculate_log_returns(double current_price, double previous
 }
 
 // 计算波动率
-static inline double calculate_volatility(const std::vector<double>& returns) noexcept {
+static inline double calculate_volatility(std::span<const double> returns) noexcept {
     if (returns.empty()) [[unlikely]] {
         return 0.0;
     }
@@ -43,7 +44,7 @@ static inline double calculate_volatility(const std::vector<double>& returns) no
 
 // 计算移动平均
 template <typename T>
-static inline double moving_average(const std::vector<T>& data, size_t window) noexcept {
+static inline double moving_average(std::span<const T> data, size_t window) noexcept {
     if (data.empty() || window == 0 || window > data.size()) [[unlikely]] {
         return 0.0;
     }
@@ -52,13 +53,18 @@ static inline double moving_average(const std::vector<T>& data, size_t window) n
     return std::accumulate(start, data.end(), 0.0) / window;
 }
 
+template <typename T>
+static inline double moving_average(const std::vector<T>& data, size_t window) noexcept {
+    return moving_average(std::span<const T>(data), window);
+}
+
 // 计算标准差
-static inline double standard_deviation(const std::vector<double>& data) noexcept {
+static inline double standard_deviation(std::span<const double> data) noexcept {
     return calculate_volatility(data);
 }
 
 // 计算最大回撤
-static inline double max_drawdown(const std::vector<double>& prices) noexcept {
+static inline double max_drawdown(std::span<const double> prices) noexcept {
     if (prices.size() < 2) [[unlikely]] {
         return 0.0;
     }
@@ -76,7 +82,7 @@ static inline double max_drawdown(const std::vector<double>& prices) noexcept {
 }
 
 // 计算夏普比率
-static inline double sharpe_ratio(const std::vector<double>& returns,
+static inline double sharpe_ratio(std::span<const double> returns,
                                   double risk_free_rate = 0.0) noexcept {
     if (returns.empty()) [[unlikely]] {
         return 0.0;
@@ -95,7 +101,7 @@ static inline double sharpe_ratio(const std::vector<double>& returns,
 }
 
 // RSI计算
-static inline double calculate_rsi(const std::vector<double>& prices, size_t period = 14) noexcept {
+static inline double calculate_rsi(std::span<const double> prices, size_t period = 14) noexcept {
     if (prices.size() <= period) [[unlikely]] {
         return 50.0;  // 中性值
     }
@@ -131,7 +137,7 @@ struct MACDResult {
     double histogram;
 };
 
-static inline MACDResult calculate_macd(const std::vector<double>& prices,
+static inline MACDResult calculate_macd(std::span<const double> prices,
                                         size_t fast_period = 12,
                                         size_t slow_period = 26,
                                         size_t signal_period = 9) noexcept {
@@ -158,7 +164,7 @@ struct BollingerBands {
     double lower;
 };
 
-static inline BollingerBands calculate_bollinger_bands(const std::vector<double>& prices,
+static inline BollingerBands calculate_bollinger_bands(std::span<const double> prices,
                                                        size_t period = 20,
                                                        double std_dev_multiplier = 2.0) noexcept {
     if (prices.size() < period) [[unlikely]] {
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace cppshares::utils {
+
+// 定点价格：以 0.0001 为单位的 64 位整数，覆盖 A 股 0.01、基金 0.001 与期权 0.0001 的报价单位
+// 比较与加减为精确的整数运算；各证券类型的最小报价单位见 data::price_tick
+class Price {
+public:
+    static constexpr int DECIMALS = 4;
+    static constexpr int64_t SCALE = 10000;
+
+    constexpr Price() = default;
+
+    static constexpr Price from_raw(int64_t raw) {
+        Price price;
+        price.raw_ = raw;
+        return price;
+    }
+
+    // 四舍五入到 0.0001
+    static Price from_double(double value) {
+        return from_raw(std::llround(value * static_cast<double>(SCALE)));
+    }
+
+    constexpr int64_t raw() const { return raw_; }
+    constexpr double to_double() const {
+        return static_cast<double>(raw_) / static_cast<double>(SCALE);
+    }
+
+    // 四舍五入到 tick 的整数倍（一半时远离零），tick 不大于 0 时原样返回
+    constexpr Price round_to(Price tick) const {
+        if (tick.raw_ <= 0) {
+            return *this;
+        }
+        int64_t half = tick.raw_ / 2;
+        int64_t units = raw_ >= 0 ? (raw_ + half) / tick.raw_ : (raw_ - half) / tick.raw_;
+        return from_raw(units * tick.raw_);
+    }
+
+    constexpr Price operator-() const { return from_raw(-raw_); }
+    constexpr Price operator+(Price other) const { return from_raw(raw_ + other.raw_); }
+    constexpr Price operator-(Price other) const { return from_raw(raw_ - other.raw_); }
+    constexpr Price operator*(int64_t quantity) const { return from_raw(raw_ * quantity); }
+    constexpr Price operator/(int64_t divisor) const { return from_raw(raw_ / divisor); }
+    constexpr Price& operator+=(Price other) {
+        raw_ += other.raw_;
+        return *this;
+    }
+    constexpr Price& operator-=(Price other) {
+        raw_ -= other.raw_;
+        return *this;
+    }
+
+    constexpr auto operator<=>(const Price& other) const = default;
+
+    // 十进制格式，decimals 小于 4 时四舍五入，大于 4 时补零（最多 9 位）
+    std::string to_string(int decimals = DECIMALS) const;
+    void append_to(std::string& out, int decimals = DECIMALS) const;
+
+private:
+    int64_t raw_ = 0;
+};
+
+constexpr Price operator*(int64_t quantity, Price price) { return price * quantity; }
+
+static_assert(std::is_trivially_copyable_v<Price> && sizeof(Price) == sizeof(int64_t));
+
+}  // namespace cppshares::utils
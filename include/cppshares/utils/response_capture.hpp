@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace cppshares::utils {
+
+// 采集档案文件头
+inline constexpr char CAPTURE_FILE_MAGIC[8] = {'C', 'P', 'S', 'C', 'A', 'P', '0', '1'};
+
+// 采集档案中每条记录的头部，后接 provider、operation、symbol 与响应体
+struct CaptureRecordHeader {
+    static constexpr uint8_t FLAG_COMPRESSED = 0x01;  // 响应体为 zlib 压缩数据
+    static constexpr uint8_t FLAG_ERROR = 0x02;       // 解析失败时采集的响应
+
+    uint32_t record_size;     // 4字节 - 头部之后的记录长度
+    uint64_t timestamp_us;    // 8字节 - 采集时间（微秒）
+    uint32_t raw_size;        // 4字节 - 响应体原始大小
+    uint32_t stored_size;     // 4字节 - 响应体存储大小
+    uint16_t provider_size;   // 2字节
+    uint16_t operation_size;  // 2字节
+    uint16_t symbol_size;     // 2字节
+    uint8_t flags;            // 1字节
+    uint8_t reserved;         // 1字节
+} __attribute__((packed));
+
+// 采集参数
+struct CaptureConfig {
+    bool enabled = true;
+    std::string path = "logs/responses.capture";
+    double sample_rate = 0.01;       // 正常响应的采样率
+    double error_sample_rate = 1.0;  // 解析失败响应的采样率
+    bool compress = true;            // 超过 compress_threshold 的响应体使用 zlib 压缩
+    size_t compress_threshold = 256;
+    size_t max_queue_bytes = 64 * 1024 * 1024;  // 待写入数据上限，超出时丢弃新记录
+};
+
+// 一条采集到的响应
+struct CapturedResponse {
+    std::chrono::system_clock::time_point timestamp;
+    std::string provider;
+    std::string operation;
+    std::string symbol;
+    std::string body;
+    bool error = false;
+};
+
+// 上游响应采集：调用线程只做采样与入队，压缩和追加写入由后台线程完成
+class ResponseCapture {
+public:
+    explicit ResponseCapture(CaptureConfig config = {});
+    ~ResponseCapture();
+
+    ResponseCapture(const ResponseCapture&) = delete;
+    ResponseCapture& operator=(const ResponseCapture&) = delete;
+
+    void capture(std::string_view provider,
+                 std::string_view operation,
+                 std::string_view symbol,
+                 std::string_view body,
+                 bool error = false);
+
+    // 阻塞直到已入队的记录全部写入文件
+    void flush();
+
+    struct Statistics {
+        size_t captured = 0;     // 已写入的记录数
+        size_t sampled_out = 0;  // 因采样未采集的响应数
+        size_t dropped = 0;      // 因队列已满丢弃的响应数
+        size_t bytes_written = 0;
+    };
+    Statistics get_statistics() const;
+
+    const CaptureConfig& config() const { return config_; }
+
+private:
+    void run();
+    void write_record(const CapturedResponse& record);
+
+    CaptureConfig config_;
+    std::ofstream file_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::deque<CapturedResponse> queue_;
+    size_t queued_bytes_ = 0;
+    bool writing_ = false;
+    bool stopping_ = false;
+
+    std::atomic<size_t> captured_{0};
+    std::atomic<size_t> sampled_out_{0};
+    std::atomic<size_t> dropped_{0};
+    std::atomic<size_t> bytes_written_{0};
+
+    std::thread writer_;
+};
+
+// 采集档案读取器，可将采集的响应按顺序回放给解析器
+class ResponseCaptureReader {
+public:
+    explicit ResponseCaptureReader(const std::string& path);
+
+    // 读取下一条记录；到达文件末尾或遇到不完整的尾部记录时返回空
+    std::optional<CapturedResponse> next();
+
+    // 依次回放所有剩余记录，返回回放条数
+    size_t replay(const std::function<void(const CapturedResponse&)>& handler);
+
+private:
+    std::ifstream file_;
+};
+
+}  // namespace cppshares::utils
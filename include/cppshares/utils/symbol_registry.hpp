@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace cppshares::utils {
+
+using SymbolId = uint32_t;
+inline constexpr SymbolId INVALID_SYMBOL_ID = UINT32_MAX;
+
+// 全局证券注册表：把证券的规范名称（CODE.MARKET.TYPE）驻留为从 0 开始的连续 id
+// id 一经分配不再改变，可直接作为按证券存放状态的数组下标；二进制日志中的 symbol_id 即为此 id
+// 按 id 取名称不加锁，名称的引用在注册表生命周期内有效
+class SymbolRegistry {
+public:
+    SymbolRegistry() = default;
+    ~SymbolRegistry();
+
+    SymbolRegistry(const SymbolRegistry&) = delete;
+    SymbolRegistry& operator=(const SymbolRegistry&) = delete;
+
+    static SymbolRegistry& global();
+
+    // 返回名称对应的 id，首次出现时分配新 id
+    SymbolId intern(std::string_view name);
+    std::optional<SymbolId> find(std::string_view name) const;
+
+    // 按给定 id 注册名称（读取其他进程写出的日志时使用），与已有映射冲突时抛出异常
+    void assign(SymbolId id, std::string_view name);
+
+    // 未注册的 id 返回空字符串
+    const std::string& name(SymbolId id) const;
+
+    // 已分配的 id 上界，按 id 存放状态的数组取这个大小
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    // 符号映射文件，每行 "id,name"
+    void load(const std::string& path);
+    bool save(const std::string& path) const;
+
+private:
+    static constexpr size_t CHUNK_SIZE = 4096;
+    static constexpr size_t MAX_CHUNKS = 1024;
+    using Chunk = std::array<std::atomic<const std::string*>, CHUNK_SIZE>;
+
+    // 调用方需持有写锁
+    void publish(SymbolId id, const std::string* name);
+
+    mutable std::shared_mutex mutex_;
+    std::deque<std::string> names_;                        // 名称存储，扩展时引用保持有效
+    std::unordered_map<std::string_view, SymbolId> ids_;  // 键指向 names_ 中的字符串
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks_{};  // id -> 名称，分块按需分配
+    std::atomic<size_t> size_{0};
+};
+
+}  // namespace cppshares::utils
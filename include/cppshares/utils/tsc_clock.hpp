@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace cppshares::utils {
+
+// 读取CPU周期计数器；不支持的平台退化为 steady_clock 纳秒
+inline uint64_t read_cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+}
+
+// 周期计数器与 system_clock 的线性换算关系
+struct TscCalibration {
+    uint64_t reference_ticks = 0;
+    int64_t reference_unix_ns = 0;
+    double ns_per_tick = 0.0;
+
+    int64_t to_unix_ns(uint64_t ticks) const {
+        auto delta = static_cast<double>(static_cast<int64_t>(ticks - reference_ticks));
+        return reference_unix_ns + static_cast<int64_t>(delta * ns_per_tick);
+    }
+};
+
+// 计数器校准：启动时以短暂间隔估计频率，之后以启动以来的长基线重新估计，消除初始误差
+class TscCalibrator {
+public:
+    explicit TscCalibrator(std::chrono::milliseconds warmup = std::chrono::milliseconds(10)) {
+        auto [ticks, unix_ns] = sample();
+        base_ticks_ = ticks;
+        base_unix_ns_ = unix_ns;
+        std::this_thread::sleep_for(warmup);
+        recalibrate();
+    }
+
+    const TscCalibration& recalibrate() {
+        auto [ticks, unix_ns] = sample();
+        if (ticks > base_ticks_) {
+            current_.ns_per_tick =
+                static_cast<double>(unix_ns - base_unix_ns_) / static_cast<double>(ticks - base_ticks_);
+        }
+        current_.reference_ticks = ticks;
+        current_.reference_unix_ns = unix_ns;
+        return current_;
+    }
+
+    const TscCalibration& current() const { return current_; }
+
+private:
+    // 用两次计数器读数夹住 system_clock 读数，取中点作为同一时刻
+    static std::pair<uint64_t, int64_t> sample() {
+        uint64_t before = read_cycle_counter();
+        auto now = std::chrono::system_clock::now();
+        uint64_t after = read_cycle_counter();
+        return {before + (after - before) / 2,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count()};
+    }
+
+    uint64_t base_ticks_ = 0;
+    int64_t base_unix_ns_ = 0;
+    TscCalibration current_;
+};
+
+}  // namespace cppshares::utils
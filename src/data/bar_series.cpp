@@ -0,0 +1,71 @@
+#include "cppshares/data/bar_series.hpp"
+
+#include <stdexcept>
+
+namespace cppshares::data {
+
+BarSeries BarSeries::from_bars(std::span<const OHLCV> bars) {
+    BarSeries series(bars.empty() ? INVALID_SYMBOL_ID : bars.front().symbol_id);
+    series.reserve(bars.size());
+    for (const auto& bar : bars) {
+        series.push_back(bar);
+    }
+    return series;
+}
+
+std::vector<OHLCV> BarSeries::to_bars() const {
+    std::vector<OHLCV> bars;
+    bars.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        bars.push_back((*this)[i]);
+    }
+    return bars;
+}
+
+void BarSeries::push_back(const OHLCV& bar) {
+    if (bar.symbol_id != symbol_id_) {
+        throw std::invalid_argument("Bar symbol does not match series: " + bar.symbol_name());
+    }
+    timestamp_us_.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                                bar.timestamp.time_since_epoch())
+                                .count());
+    open_.push_back(bar.open);
+    high_.push_back(bar.high);
+    low_.push_back(bar.low);
+    close_.push_back(bar.close);
+    volume_.push_back(bar.volume);
+    amount_.push_back(bar.amount);
+}
+
+void BarSeries::reserve(size_t capacity) {
+    timestamp_us_.reserve(capacity);
+    open_.reserve(capacity);
+    high_.reserve(capacity);
+    low_.reserve(capacity);
+    close_.reserve(capacity);
+    volume_.reserve(capacity);
+    amount_.reserve(capacity);
+}
+
+void BarSeries::clear() {
+    timestamp_us_.clear();
+    open_.clear();
+    high_.clear();
+    low_.clear();
+    close_.clear();
+    volume_.clear();
+    amount_.clear();
+}
+
+OHLCV BarSeries::operator[](size_t index) const {
+    return {.symbol_id = symbol_id_,
+            .timestamp = timestamp(index),
+            .open = open_[index],
+            .high = high_[index],
+            .low = low_[index],
+            .close = close_[index],
+            .volume = volume_[index],
+            .amount = amount_[index]};
+}
+
+}  // namespace cppshares::data
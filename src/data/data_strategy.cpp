@@ -1,10 +1,157 @@
 #include "cppshares/data/data_strategy.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <future>
 #include <random>
 
 namespace cppshares::data {
 
+namespace {
+
+// 对冲请求的共享状态，由发起线程与后台请求线程共同持有
+template <typename T>
+struct HedgeRace {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::optional<T> result;
+    size_t winner = 0;
+    size_t finished = 0;
+};
+
+int64_t elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                 start)
+        .count();
+}
+
+// K线缓存到当前K线结束：分钟与小时K线按北京时间对齐周期边界，日K及以上缓存到次日零点
+std::chrono::steady_clock::duration kline_ttl(KlinePeriod period) {
+    using namespace std::chrono;
+    constexpr auto beijing_offset = hours(8);
+
+    seconds bar{};
+    switch (period) {
+        case KlinePeriod::MIN_1:
+            bar = minutes(1);
+            break;
+        case KlinePeriod::MIN_5:
+            bar = minutes(5);
+            break;
+        case KlinePeriod::MIN_15:
+            bar = minutes(15);
+            break;
+        case KlinePeriod::MIN_30:
+            bar = minutes(30);
+            break;
+        case KlinePeriod::HOUR_1:
+            bar = hours(1);
+            break;
+        case KlinePeriod::HOUR_4:
+            bar = hours(4);
+            break;
+        default:
+            bar = hours(24);
+            break;
+    }
+
+    auto now = duration_cast<milliseconds>(system_clock::now().time_since_epoch()) + beijing_offset;
+    return bar - now % bar;
+}
+
+}  // namespace
+
+// LatencyHistogram 实现
+void LatencyHistogram::record(int64_t latency_ms) {
+    auto it = std::lower_bound(BUCKET_BOUNDS_MS.begin(), BUCKET_BOUNDS_MS.end(), latency_ms);
+    buckets_[it - BUCKET_BOUNDS_MS.begin()].fetch_add(1, std::memory_order_relaxed);
+
+    // 只有恰好跨过阈值的线程执行衰减，并发写入带来的误差可以忽略
+    if (samples_.fetch_add(1, std::memory_order_relaxed) + 1 == DECAY_THRESHOLD) {
+        for (auto& bucket : buckets_) {
+            bucket.store(bucket.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+        }
+        samples_.fetch_sub(DECAY_THRESHOLD / 2, std::memory_order_relaxed);
+    }
+}
+
+std::optional<int64_t> LatencyHistogram::percentile(double p) const {
+    std::array<uint64_t, BUCKET_BOUNDS_MS.size() + 1> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return std::nullopt;
+    }
+
+    auto target = static_cast<uint64_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(total));
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < BUCKET_BOUNDS_MS.size(); ++i) {
+        cumulative += counts[i];
+        if (cumulative >= std::max<uint64_t>(target, 1)) {
+            return BUCKET_BOUNDS_MS[i];
+        }
+    }
+    return BUCKET_BOUNDS_MS.back() * 2;  // 溢出桶
+}
+
+uint64_t LatencyHistogram::sample_count() const {
+    return samples_.load(std::memory_order_relaxed);
+}
+
+// TokenBucket 实现
+void TokenBucket::configure(int requests_per_minute, std::chrono::milliseconds burst_window) {
+    if (requests_per_minute <= 0) {
+        interval_ns_.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    int64_t interval = std::chrono::nanoseconds(std::chrono::minutes(1)).count() / requests_per_minute;
+    int64_t burst = std::max<int64_t>(
+        1, std::chrono::nanoseconds(burst_window).count() / std::max<int64_t>(interval, 1));
+    burst_tolerance_ns_.store((burst - 1) * interval, std::memory_order_relaxed);
+    interval_ns_.store(interval, std::memory_order_relaxed);
+}
+
+bool TokenBucket::try_acquire() {
+    int64_t interval = interval_ns_.load(std::memory_order_relaxed);
+    if (interval <= 0) {
+        return true;
+    }
+    int64_t tolerance = burst_tolerance_ns_.load(std::memory_order_relaxed);
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count();
+
+    // 理论到达时间领先当前时间超过突发容忍度即桶空；否则 CAS 推进一个间隔
+    int64_t tat = theoretical_arrival_ns_.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t base = std::max(tat, now);
+        if (base - now > tolerance) {
+            return false;
+        }
+        if (theoretical_arrival_ns_.compare_exchange_weak(
+                tat, base + interval, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+// DataProvider 默认实现
+std::vector<std::optional<MarketTick>> DataProvider::get_realtime_quotes(
+    std::span<const Symbol> symbols) {
+    std::vector<std::optional<MarketTick>> ticks;
+    ticks.reserve(symbols.size());
+    for (const auto& symbol : symbols) {
+        ticks.push_back(get_realtime_quote(symbol));
+    }
+    return ticks;
+}
+
 // FailoverStrategy 实现
 std::vector<std::shared_ptr<DataProvider>> FailoverStrategy::select_providers(
     DataType data_type,
@@ -44,24 +191,84 @@ std::vector<std::shared_ptr<DataProvider>> RoundRobinStrategy::select_providers(
 std::vector<std::shared_ptr<DataProvider>> WeightedRandomStrategy::select_providers(
     DataType data_type,
     const std::vector<std::shared_ptr<DataProvider>>& available_providers) {
+    return select_providers_with_health(
+        data_type, available_providers, std::vector<ProviderHealth>(available_providers.size()));
+}
+
+std::vector<std::shared_ptr<DataProvider>> WeightedRandomStrategy::select_providers_with_health(
+    DataType data_type,
+    const std::vector<std::shared_ptr<DataProvider>>& available_providers,
+    const std::vector<ProviderHealth>& health) {
     if (available_providers.empty())
         return {};
 
-    // 简单的随机选择，可以根据成功率加权
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, available_providers.size() - 1);
+    // 每个线程独立的随机数发生器，选择过程无共享状态
+    thread_local std::mt19937_64 gen(std::random_device{}());
+    std::uniform_real_distribution<double> dis(std::numeric_limits<double>::min(), 1.0);
+
+    // 尚无样本的提供者使用已知提供者的平均延迟，保证它们有机会被探索
+    double known_latency_sum = 0.0;
+    size_t known_count = 0;
+    for (const auto& h : health) {
+        if (h.status != ProviderStatus::UNKNOWN) {
+            known_latency_sum += static_cast<double>(h.avg_response_time_ms);
+            known_count++;
+        }
+    }
+    double fallback_latency_ms = known_count > 0 ? known_latency_sum / known_count : 0.0;
+
+    // 加权无放回抽样（指数竞赛）：key = -ln(u) / w，按 key 升序即得到加权随机顺序
+    std::vector<std::pair<double, size_t>> keys;
+    keys.reserve(available_providers.size());
+    for (size_t i = 0; i < available_providers.size(); ++i) {
+        double weight = i < health.size() ? provider_weight(health[i], fallback_latency_ms)
+                                          : provider_weight(ProviderHealth{}, fallback_latency_ms);
+        keys.emplace_back(-std::log(dis(gen)) / weight, i);
+    }
+    std::sort(keys.begin(), keys.end());
 
     std::vector<std::shared_ptr<DataProvider>> result;
-    result.push_back(available_providers[dis(gen)]);
+    result.reserve(keys.size());
+    for (const auto& [key, index] : keys) {
+        result.push_back(available_providers[index]);
+    }
 
     return result;
 }
 
+double WeightedRandomStrategy::provider_weight(const ProviderHealth& health,
+                                               double fallback_latency_ms) {
+    bool known = health.status != ProviderStatus::UNKNOWN;
+    double success_rate = known ? health.success_rate : 1.0;
+    double latency_ms =
+        known ? static_cast<double>(health.avg_response_time_ms) : fallback_latency_ms;
+
+    // 成功率取平方拉开差距；下限保证偶发失败的提供者仍有少量流量用于恢复统计
+    double reliability = std::max(success_rate * success_rate, 0.01);
+    return reliability / (1.0 + latency_ms);
+}
+
 // DataAggregator 实现
+DataAggregator::~DataAggregator() {
+    // 落后的请求仍持有提供者与计数器，先等它们结束再析构其余成员
+    std::lock_guard<std::mutex> lock(attempts_mutex_);
+    for (auto& attempt : attempts_) {
+        attempt.wait();
+    }
+}
+
 void DataAggregator::register_provider(std::shared_ptr<DataProvider> provider) {
     std::lock_guard<std::mutex> lock(mutex_);
+    auto& counters = provider_counters_[provider->get_name()];
+    if (!counters) {
+        counters = std::make_shared<ProviderCounters>();
+        counters->breaker_config = breaker_config_;
+        counters->rate_limiter.configure(
+            rate_limit_config_.enabled ? provider->get_rate_limit() : 0,
+            rate_limit_config_.burst_window);
+    }
     providers_.push_back(provider);
+    rebuild_snapshot();
 }
 
 void DataAggregator::unregister_provider(const std::string& provider_name) {
@@ -72,49 +279,240 @@ void DataAggregator::unregister_provider(const std::string& provider_name) {
                                         return provider->get_name() == provider_name;
                                     }),
                      providers_.end());
+    rebuild_snapshot();
 }
 
 void DataAggregator::set_strategy(std::unique_ptr<DataStrategy> strategy) {
     std::lock_guard<std::mutex> lock(mutex_);
     strategy_ = std::move(strategy);
+    rebuild_snapshot();
+}
+
+void DataAggregator::set_circuit_breaker_config(const CircuitBreakerConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    breaker_config_ = config;
+    for (auto& [name, counters] : provider_counters_) {
+        std::lock_guard<std::mutex> health_lock(counters->health_mutex);
+        counters->breaker_config = config;
+    }
+}
+
+void DataAggregator::set_rate_limit_config(const RateLimitConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rate_limit_config_ = config;
+    for (const auto& provider : providers_) {
+        provider_counters_[provider->get_name()]->rate_limiter.configure(
+            config.enabled ? provider->get_rate_limit() : 0, config.burst_window);
+    }
+}
+
+void DataAggregator::set_cache_config(const CacheConfig& config) {
+    cache_enabled_.store(config.enabled, std::memory_order_relaxed);
+    quote_ttl_ms_.store(config.quote_ttl.count(), std::memory_order_relaxed);
+    quote_cache_.set_capacity(config.capacity);
+    kline_cache_.set_capacity(config.capacity);
+    if (!config.enabled) {
+        quote_cache_.clear();
+        kline_cache_.clear();
+    }
 }
 
 std::optional<MarketTick> DataAggregator::get_realtime_quote(const Symbol& symbol) {
-    return try_get_data<MarketTick>(
-        DataType::REALTIME_QUOTE,
-        [&symbol](std::shared_ptr<DataProvider> provider) -> std::optional<MarketTick> {
-            return provider->get_realtime_quote(symbol);
-        });
+    RequestKey key{.type = DataType::REALTIME_QUOTE, .symbol = symbol};
+    bool cache_enabled = cache_enabled_.load(std::memory_order_relaxed);
+    if (cache_enabled) {
+        if (auto cached = quote_cache_.get(key)) {
+            return cached;
+        }
+    }
+
+    return quote_flights_.run(key, [&] {
+        auto result = try_get_data<MarketTick>(
+            DataType::REALTIME_QUOTE,
+            // 按值捕获：对冲路径中落后的请求可能在调用返回后才结束
+            [symbol](std::shared_ptr<DataProvider> provider) -> std::optional<MarketTick> {
+                return provider->get_realtime_quote(symbol);
+            });
+        if (result && cache_enabled) {
+            quote_cache_.put(
+                key, *result, std::chrono::milliseconds(quote_ttl_ms_.load(std::memory_order_relaxed)));
+        }
+        return result;
+    });
 }
 
 std::vector<OHLCV> DataAggregator::get_kline_data(const Symbol& symbol,
                                                   KlinePeriod period,
                                                   int limit) {
-    auto result = try_get_data<std::vector<OHLCV>>(
-        DataType::KLINE_DATA,
-        [&](std::shared_ptr<DataProvider> provider) -> std::optional<std::vector<OHLCV>> {
-            auto data = provider->get_kline_data(symbol, period, limit);
-            return data.empty() ? std::nullopt : std::make_optional(data);
-        });
+    RequestKey key{.type = DataType::KLINE_DATA, .symbol = symbol, .period = period, .limit = limit};
+    bool cache_enabled = cache_enabled_.load(std::memory_order_relaxed);
+    if (cache_enabled) {
+        if (auto cached = kline_cache_.get(key)) {
+            return std::move(*cached);
+        }
+    }
+
+    return kline_flights_.run(key, [&] {
+        auto result = try_get_data<std::vector<OHLCV>>(
+            DataType::KLINE_DATA,
+            [symbol, period, limit](
+                std::shared_ptr<DataProvider> provider) -> std::optional<std::vector<OHLCV>> {
+                auto data = provider->get_kline_data(symbol, period, limit);
+                return data.empty() ? std::nullopt : std::make_optional(std::move(data));
+            });
+
+        if (result && cache_enabled) {
+            kline_cache_.put(key, *result, kline_ttl(period));
+        }
+        return result.value_or(std::vector<OHLCV>{});
+    });
+}
+
+std::vector<std::optional<MarketTick>> DataAggregator::get_realtime_quotes(
+    std::span<const Symbol> symbols) {
+    std::vector<std::optional<MarketTick>> ticks(symbols.size());
+    if (symbols.empty()) {
+        return ticks;
+    }
+
+    bool cache_enabled = cache_enabled_.load(std::memory_order_relaxed);
+    std::chrono::milliseconds quote_ttl(quote_ttl_ms_.load(std::memory_order_relaxed));
+
+    // 尚未获取到行情的证券下标，缓存命中的证券不再请求
+    std::vector<size_t> pending;
+    pending.reserve(symbols.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        if (cache_enabled) {
+            ticks[i] = quote_cache_.get({.type = DataType::REALTIME_QUOTE, .symbol = symbols[i]});
+        }
+        if (!ticks[i]) {
+            pending.push_back(i);
+        }
+    }
+
+    if (pending.empty()) {
+        return ticks;
+    }
+
+    auto snapshot = load_snapshot();
+    if (!snapshot->strategy || snapshot->providers.empty()) {
+        return ticks;
+    }
+
+    auto providers = available_providers(*snapshot);
+    auto selected_providers = snapshot->strategy->select_providers_with_health(
+        DataType::REALTIME_QUOTE, providers, collect_health(*snapshot, providers));
+
+    for (auto& provider : selected_providers) {
+        if (pending.empty()) {
+            break;
+        }
+
+        auto counters = find_counters(*snapshot, provider.get());
+        size_t batch_size = std::max<size_t>(provider->get_max_batch_size(), 1);
+
+        std::vector<size_t> still_pending;
+        std::vector<Symbol> chunk;
+        chunk.reserve(std::min(batch_size, pending.size()));
 
-    return result.value_or(std::vector<OHLCV>{});
+        for (size_t begin = 0; begin < pending.size(); begin += batch_size) {
+            size_t end = std::min(begin + batch_size, pending.size());
+            chunk.clear();
+            for (size_t i = begin; i < end; ++i) {
+                chunk.push_back(symbols[pending[i]]);
+            }
+
+            if (!admit(counters.get())) {
+                for (size_t i = begin; i < end; ++i) {
+                    still_pending.push_back(pending[i]);
+                }
+                continue;
+            }
+
+            total_requests_.fetch_add(1, std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::optional<MarketTick>> chunk_ticks;
+            bool threw = false;
+            try {
+                chunk_ticks = provider->get_realtime_quotes(chunk);
+            } catch (...) {
+                threw = true;
+            }
+
+            bool any_success = false;
+            for (size_t i = begin; i < end; ++i) {
+                size_t offset = i - begin;
+                if (offset < chunk_ticks.size() && chunk_ticks[offset]) {
+                    if (cache_enabled) {
+                        quote_cache_.put({.type = DataType::REALTIME_QUOTE, .symbol = chunk[offset]},
+                                         *chunk_ticks[offset],
+                                         quote_ttl);
+                    }
+                    ticks[pending[i]] = std::move(chunk_ticks[offset]);
+                    any_success = true;
+                } else {
+                    still_pending.push_back(pending[i]);
+                }
+            }
+
+            record_outcome(*provider, counters.get(), any_success, threw, elapsed_ms(start));
+            if (any_success) {
+                successful_requests_.fetch_add(1, std::memory_order_relaxed);
+                record_success(counters.get());
+            }
+        }
+
+        pending = std::move(still_pending);
+    }
+
+    if (!pending.empty()) {
+        failed_requests_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return ticks;
 }
 
 void DataAggregator::update_provider_health() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& provider : providers_) {
-        bool is_healthy = provider->health_check();
-        // 更新健康状态逻辑可以在这里实现
+    // 健康检查会发起网络请求，在快照上执行，不持有 mutex_
+    auto snapshot = load_snapshot();
+    for (auto& provider : snapshot->providers) {
+        auto counters = find_counters(*snapshot, provider.get());
+        if (!counters) {
+            continue;
+        }
+
+        // 只探测熔断冷却期已过的提供者，正常提供者的状态由实际请求更新
+        bool tripped = false;
+        {
+            std::lock_guard<std::mutex> lock(counters->health_mutex);
+            tripped = counters->health.status == ProviderStatus::FAILED ||
+                      counters->health.status == ProviderStatus::RATE_LIMITED;
+        }
+        if (!tripped || !acquire_permit(counters.get())) {
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool is_healthy = false;
+        try {
+            is_healthy = provider->health_check();
+        } catch (...) {
+            is_healthy = false;
+        }
+        update_provider_metrics(counters.get(), is_healthy, elapsed_ms(start));
     }
 }
 
 std::map<std::string, ProviderHealth> DataAggregator::get_provider_health() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto snapshot = load_snapshot();
     std::map<std::string, ProviderHealth> health_map;
 
-    for (const auto& provider : providers_) {
+    for (const auto& provider : snapshot->providers) {
+        auto counters = find_counters(*snapshot, provider.get());
         ProviderHealth health;
-        health.status = ProviderStatus::UNKNOWN;
+        if (counters) {
+            std::lock_guard<std::mutex> lock(counters->health_mutex);
+            health = counters->health;
+        }
         health_map[provider->get_name()] = health;
     }
 
@@ -122,53 +520,433 @@ std::map<std::string, ProviderHealth> DataAggregator::get_provider_health() cons
 }
 
 DataAggregator::Statistics DataAggregator::get_statistics() const {
+    Statistics stats;
+    stats.total_requests = total_requests_.load(std::memory_order_relaxed);
+    stats.successful_requests = successful_requests_.load(std::memory_order_relaxed);
+    stats.failed_requests = failed_requests_.load(std::memory_order_relaxed);
+    stats.hedged_requests = hedged_requests_.load(std::memory_order_relaxed);
+    stats.hedge_wins = hedge_wins_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(attempts_mutex_);
+        stats.pending_attempts = attempts_.size();
+    }
+    stats.short_circuited_requests = short_circuited_requests_.load(std::memory_order_relaxed);
+    stats.rate_limited_skips = rate_limited_skips_.load(std::memory_order_relaxed);
+    stats.coalesced_requests = quote_flights_.coalesced_count() + kline_flights_.coalesced_count();
+    stats.cache_hits = quote_cache_.hits() + kline_cache_.hits();
+    stats.cache_misses = quote_cache_.misses() + kline_cache_.misses();
+    stats.cache_evictions = quote_cache_.evictions() + kline_cache_.evictions();
+
     std::lock_guard<std::mutex> lock(mutex_);
-    return stats_;
+    for (const auto& [name, counters] : provider_counters_) {
+        size_t usage = counters->usage_count.load(std::memory_order_relaxed);
+        if (usage > 0) {
+            stats.provider_usage_count[name] = usage;
+        }
+        size_t failures = counters->failure_count.load(std::memory_order_relaxed);
+        if (failures > 0) {
+            stats.provider_failure_count[name] = failures;
+        }
+    }
+    return stats;
+}
+
+std::shared_ptr<const DataAggregator::Snapshot> DataAggregator::load_snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+}
+
+void DataAggregator::rebuild_snapshot() {
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->providers = providers_;
+    snapshot->strategy = strategy_;
+    for (const auto& provider : providers_) {
+        snapshot->counters[provider.get()] = provider_counters_[provider->get_name()];
+    }
+    snapshot_ = std::move(snapshot);
+}
+
+std::vector<std::shared_ptr<DataProvider>> DataAggregator::available_providers(
+    const Snapshot& snapshot) {
+    std::vector<std::shared_ptr<DataProvider>> available;
+    available.reserve(snapshot.providers.size());
+    for (const auto& provider : snapshot.providers) {
+        if (accepts_traffic(find_counters(snapshot, provider.get()).get())) {
+            available.push_back(provider);
+        } else {
+            short_circuited_requests_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return available;
+}
+
+bool DataAggregator::admit(ProviderCounters* counters) {
+    // 先取令牌再过熔断器，避免占用半开探测名额后因限流而不发请求
+    if (counters && !counters->rate_limiter.try_acquire()) {
+        rate_limited_skips_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!acquire_permit(counters)) {
+        short_circuited_requests_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+std::vector<ProviderHealth> DataAggregator::collect_health(
+    const Snapshot& snapshot, const std::vector<std::shared_ptr<DataProvider>>& providers) {
+    std::vector<ProviderHealth> health(providers.size());
+    for (size_t i = 0; i < providers.size(); ++i) {
+        if (auto counters = find_counters(snapshot, providers[i].get())) {
+            std::lock_guard<std::mutex> lock(counters->health_mutex);
+            health[i] = counters->health;
+        }
+    }
+    return health;
+}
+
+std::shared_ptr<DataAggregator::ProviderCounters> DataAggregator::find_counters(
+    const Snapshot& snapshot, const DataProvider* provider) {
+    auto it = snapshot.counters.find(provider);
+    return it != snapshot.counters.end() ? it->second : nullptr;
+}
+
+std::chrono::milliseconds DataAggregator::hedge_delay(const ProviderCounters* counters,
+                                                      const HedgePolicy& policy) {
+    std::chrono::milliseconds delay = policy.default_delay;
+    if (counters && counters->latency.sample_count() >= policy.min_samples) {
+        if (auto latency = counters->latency.percentile(policy.percentile)) {
+            delay = std::chrono::milliseconds(*latency);
+        }
+    }
+    return std::max(delay, policy.min_delay);
+}
+
+void DataAggregator::keep_attempt(std::future<void> attempt) {
+    std::lock_guard<std::mutex> lock(attempts_mutex_);
+    std::erase_if(attempts_, [](const std::future<void>& attempt) {
+        return attempt.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    attempts_.push_back(std::move(attempt));
 }
 
 template <typename T>
 std::optional<T> DataAggregator::try_get_data(
     DataType data_type,
     std::function<std::optional<T>(std::shared_ptr<DataProvider>)> getter) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    // 短锁内取快照，之后的策略选择与网络I/O均不持有 mutex_
+    auto snapshot = load_snapshot();
 
-    if (!strategy_ || providers_.empty()) {
+    if (!snapshot->strategy || snapshot->providers.empty()) {
         return std::nullopt;
     }
 
-    auto selected_providers = strategy_->select_providers(data_type, providers_);
+    auto providers = available_providers(*snapshot);
+    if (providers.empty()) {
+        // 所有提供者都处于熔断期，直接失败而不是等待连接超时
+        failed_requests_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    auto selected_providers = snapshot->strategy->select_providers_with_health(
+        data_type, providers, collect_health(*snapshot, providers));
+
+    if (auto policy = snapshot->strategy->hedge_policy();
+        policy && selected_providers.size() > 1) {
+        return try_get_data_hedged<T>(*snapshot, selected_providers, *policy, std::move(getter));
+    }
 
     for (auto& provider : selected_providers) {
-        stats_.total_requests++;
+        auto counters = find_counters(*snapshot, provider.get());
+        if (!admit(counters.get())) {
+            continue;
+        }
+
+        total_requests_.fetch_add(1, std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
 
         try {
             auto result = getter(provider);
+            record_outcome(*provider, counters.get(), result.has_value(), false, elapsed_ms(start));
             if (result) {
-                stats_.successful_requests++;
-                record_success(provider->get_name());
+                successful_requests_.fetch_add(1, std::memory_order_relaxed);
+                record_success(counters.get());
                 return result;
             }
         } catch (...) {
-            record_failure(provider->get_name());
+            record_outcome(*provider, counters.get(), false, true, elapsed_ms(start));
         }
     }
 
-    stats_.failed_requests++;
+    failed_requests_.fetch_add(1, std::memory_order_relaxed);
     return std::nullopt;
 }
 
-void DataAggregator::record_success(const std::string& provider_name) {
-    stats_.provider_usage_count[provider_name]++;
+template <typename T>
+std::optional<T> DataAggregator::try_get_data_hedged(
+    const Snapshot& snapshot,
+    const std::vector<std::shared_ptr<DataProvider>>& selected_providers,
+    const HedgePolicy& policy,
+    std::function<std::optional<T>(std::shared_ptr<DataProvider>)> getter) {
+    auto race = std::make_shared<HedgeRace<T>>();
+    size_t launched = 0;  // 已遍历的下标，包含被熔断跳过的提供者
+    size_t started = 0;   // 实际发出的请求数
+    size_t first_hedge = selected_providers.size();  // 第一个因对冲而发出的请求下标
+    auto last_launch = std::chrono::steady_clock::now();
+    std::shared_ptr<ProviderCounters> last_counters;
+
+    bool hedging = true;  // 对冲请求达到上限后停止对冲
+    // 提供者接口是同步阻塞的，无法取消；落后的请求执行结束后结果被丢弃，
+    // 其 future 由聚合器保存，之后发出请求时或析构函数负责回收
+    auto launch = [&](bool hedge) -> bool {
+        while (launched < selected_providers.size()) {
+            size_t index = launched++;
+            auto provider = selected_providers[index];
+            auto counters = find_counters(snapshot, provider.get());
+            if (!admit(counters.get())) {
+                continue;
+            }
+
+            total_requests_.fetch_add(1, std::memory_order_relaxed);
+            last_launch = std::chrono::steady_clock::now();
+            last_counters = counters;
+            started++;
+
+            auto* hedge_slot = hedge ? &hedges_in_flight_ : nullptr;
+            auto task = [race, provider, counters, getter, index, hedge_slot] {
+                auto start = std::chrono::steady_clock::now();
+                std::optional<T> result;
+                bool threw = false;
+                try {
+                    result = getter(provider);
+                } catch (...) {
+                    threw = true;
+                }
+                record_outcome(
+                    *provider, counters.get(), result.has_value(), threw, elapsed_ms(start));
+
+                {
+                    std::lock_guard<std::mutex> lock(race->mutex);
+                    race->finished++;
+                    if (result && !race->result) {
+                        race->result = std::move(result);
+                        race->winner = index;
+                    }
+                }
+                race->cv.notify_all();
+                if (hedge_slot) {
+                    hedge_slot->fetch_sub(1, std::memory_order_relaxed);
+                }
+            };
+            keep_attempt(std::async(std::launch::async, std::move(task)));
+            return true;
+        }
+        return false;
+    };
+
+    launch(false);
+
+    std::unique_lock<std::mutex> lock(race->mutex);
+    while (!race->result) {
+        if (race->finished == started) {
+            if (launched == selected_providers.size()) {
+                break;
+            }
+            // 已发出的请求全部失败，立即故障转移到下一个提供者
+            lock.unlock();
+            launch(false);
+            lock.lock();
+            continue;
+        }
+
+        if (launched == selected_providers.size() || !hedging) {
+            race->cv.wait(lock);
+            continue;
+        }
+
+        auto deadline = last_launch + hedge_delay(last_counters.get(), policy);
+        bool settled = race->cv.wait_until(lock, deadline, [&] {
+            return race->result.has_value() || race->finished == started;
+        });
+        if (!settled) {
+            // 最近发出的请求超过其延迟分位数仍未返回，发出对冲请求
+            lock.unlock();
+            size_t hedge_index = launched;
+            // 先占用对冲名额，请求结束时归还；没有可发出的提供者时立即归还
+            if (hedges_in_flight_.fetch_add(1, std::memory_order_relaxed) >=
+                policy.max_in_flight) {
+                hedges_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+                hedging = false;
+            } else if (launch(true)) {
+                hedged_requests_.fetch_add(1, std::memory_order_relaxed);
+                first_hedge = std::min(first_hedge, hedge_index);
+            } else {
+                hedges_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            lock.lock();
+        }
+    }
+
+    if (!race->result) {
+        failed_requests_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    successful_requests_.fetch_add(1, std::memory_order_relaxed);
+    record_success(find_counters(snapshot, selected_providers[race->winner].get()).get());
+    if (race->winner >= first_hedge) {
+        hedge_wins_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return std::move(race->result);
+}
+
+void DataAggregator::record_success(ProviderCounters* counters) {
+    if (counters) {
+        counters->usage_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void DataAggregator::record_failure(ProviderCounters* counters) {
+    if (counters) {
+        counters->failure_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void DataAggregator::record_outcome(DataProvider& provider,
+                                    ProviderCounters* counters,
+                                    bool success,
+                                    bool threw,
+                                    int64_t response_time_ms) {
+    // 总是取走信号，避免残留的标记在之后无关的请求中被误用
+    bool rate_limited = provider.take_rate_limited_signal();
+    bool request_failed = provider.take_request_failed_signal();
+
+    // 上游正常答复但没有数据（停牌、退市或未知证券）时提供者本身是健康的
+    bool healthy = success || (!threw && !rate_limited && !request_failed);
+    if (!healthy) {
+        record_failure(counters);
+    }
+    update_provider_metrics(counters, healthy, response_time_ms);
+
+    if (!success && rate_limited) {
+        mark_rate_limited(counters);
+    }
+}
+
+void DataAggregator::mark_rate_limited(ProviderCounters* counters) {
+    if (!counters) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(counters->health_mutex);
+    counters->health.status = ProviderStatus::RATE_LIMITED;
+    counters->open_until =
+        std::chrono::steady_clock::now() + counters->breaker_config.rate_limited_duration;
+    counters->probe_in_flight = false;
 }
 
-void DataAggregator::record_failure(const std::string& provider_name) {
-    // 记录失败统计
+bool DataAggregator::accepts_traffic(ProviderCounters* counters) {
+    if (!counters) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(counters->health_mutex);
+    auto status = counters->health.status;
+    if (status != ProviderStatus::FAILED && status != ProviderStatus::RATE_LIMITED) {
+        return true;
+    }
+
+    // 熔断期内拒绝；冷却后只要没有进行中的探测就允许（探测超时视为丢失）
+    auto now = std::chrono::steady_clock::now();
+    if (now < counters->open_until) {
+        return false;
+    }
+    return !counters->probe_in_flight ||
+           now >= counters->open_until + counters->breaker_config.open_duration;
 }
 
-void DataAggregator::update_provider_metrics(std::shared_ptr<DataProvider> provider,
+bool DataAggregator::acquire_permit(ProviderCounters* counters) {
+    if (!counters) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(counters->health_mutex);
+    auto status = counters->health.status;
+    if (status != ProviderStatus::FAILED && status != ProviderStatus::RATE_LIMITED) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < counters->open_until ||
+        (counters->probe_in_flight &&
+         now < counters->open_until + counters->breaker_config.open_duration)) {
+        return false;
+    }
+
+    // 半开状态：占用唯一的探测名额，open_until 记录探测开始时间用于判断探测超时
+    counters->probe_in_flight = true;
+    counters->open_until = now;
+    return true;
+}
+
+void DataAggregator::update_provider_metrics(ProviderCounters* counters,
                                              bool success,
                                              int64_t response_time_ms) {
-    // 更新提供者指标
+    if (!counters) {
+        return;
+    }
+    // 失败请求的耗时同样计入，超时型故障正是对冲需要覆盖的尾延迟
+    counters->latency.record(response_time_ms);
+
+    std::lock_guard<std::mutex> lock(counters->health_mutex);
+    auto& health = counters->health;
+    const auto& config = counters->breaker_config;
+
+    // 指数加权更新成功率与延迟，首个样本直接作为初值
+    double outcome = success ? 1.0 : 0.0;
+    if (!counters->has_samples) {
+        health.success_rate = outcome;
+        counters->ewma_latency_ms = static_cast<double>(response_time_ms);
+        counters->has_samples = true;
+    } else {
+        health.success_rate += config.ewma_alpha * (outcome - health.success_rate);
+        counters->ewma_latency_ms +=
+            config.ewma_alpha * (static_cast<double>(response_time_ms) - counters->ewma_latency_ms);
+    }
+    health.avg_response_time_ms = static_cast<int64_t>(counters->ewma_latency_ms + 0.5);
+
+    bool tripped =
+        health.status == ProviderStatus::FAILED || health.status == ProviderStatus::RATE_LIMITED;
+
+    if (success) {
+        // 成功（包括半开探测成功）即闭合熔断器
+        health.last_success = std::chrono::system_clock::now();
+        health.consecutive_failures = 0;
+        counters->probe_in_flight = false;
+        health.status = health.success_rate < config.degraded_success_rate
+                            ? ProviderStatus::DEGRADED
+                            : ProviderStatus::HEALTHY;
+        return;
+    }
+
+    health.last_failure = std::chrono::system_clock::now();
+    health.consecutive_failures++;
+
+    auto now = std::chrono::steady_clock::now();
+    if (tripped && now < counters->open_until) {
+        // 熔断前已发出的请求在冷却期内返回失败，不再推迟冷却结束时间
+        return;
+    }
+    if (tripped || health.consecutive_failures >= config.failure_threshold) {
+        // 熔断或半开探测失败：重新进入冷却期，限流状态保持不变
+        if (health.status != ProviderStatus::RATE_LIMITED) {
+            health.status = ProviderStatus::FAILED;
+        }
+        counters->open_until = now + config.open_duration;
+        counters->probe_in_flight = false;
+    } else {
+        health.status = ProviderStatus::DEGRADED;
+    }
 }
 
-}  // namespace cppshares::data
\ No newline at end of file
+}  // namespace cppshares::data
@@ -1,52 +1,198 @@
 #include "cppshares/data/data_types.hpp"
 
+#include <algorithm>
 #include <array>
-#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "cppshares/utils/logger.hpp"
 
 namespace cppshares::data {
 
+namespace {
+
+constexpr std::array<std::string_view, 5> MARKET_NAMES = {"SH", "SZ", "BJ", "HK", "US"};
+constexpr std::array<std::string_view, 7> TYPE_NAMES = {
+    "STOCK", "INDEX", "ETF", "CONVERTIBLE", "BOND", "FUTURE", "OPTION"};
+
+constexpr int CODE_BITS = 6;
+constexpr int CODE_SHIFT = 6;  // 代码字符位于市场与类型之上
+
+// 代码字符的 6 位编码，0 表示空位
+constexpr uint64_t encode_char(char c) {
+    if (c >= '0' && c <= '9') {
+        return static_cast<uint64_t>(c - '0') + 1;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<uint64_t>(c - 'A') + 11;
+    }
+    if (c >= 'a' && c <= 'z') {
+        return static_cast<uint64_t>(c - 'a') + 37;
+    }
+    return c == '-' ? 63 : 0;
+}
+
+constexpr std::array<char, 64> make_decode_table() {
+    std::array<char, 64> table{};
+    for (int c = 0; c < 128; ++c) {
+        auto value = encode_char(static_cast<char>(c));
+        if (value != 0) {
+            table[value] = static_cast<char>(c);
+        }
+    }
+    return table;
+}
+
+constexpr auto DECODE_TABLE = make_decode_table();
+
+template <size_t N>
+size_t find_name(const std::array<std::string_view, N>& names, std::string_view name) {
+    for (size_t i = 0; i < N; ++i) {
+        if (names[i] == name) {
+            return i;
+        }
+    }
+    return N;
+}
+
+// 调用方保证代码可编码
+uint64_t pack_key(std::string_view code, Market market, SecurityType type) {
+    uint64_t packed = 0;
+    for (size_t i = 0; i < Symbol::MAX_CODE_LENGTH; ++i) {
+        packed = (packed << CODE_BITS) | (i < code.size() ? encode_char(code[i]) : 0);
+    }
+    return (packed << CODE_SHIFT) | (static_cast<uint64_t>(market) & 0x7) << 3 |
+           (static_cast<uint64_t>(type) & 0x7);
+}
+
+struct SymbolFields {
+    std::string_view code;
+    Market market = Market::SH;
+    SecurityType type = SecurityType::STOCK;
+};
+
+// 按 "CODE.MARKET.TYPE" 拆分名称，缺少或无法识别的市场、类型取沪市、股票
+SymbolFields split_symbol(std::string_view symbol_str) {
+    auto first_dot = symbol_str.find('.');
+    SymbolFields fields{.code = symbol_str.substr(0, first_dot)};
+    if (first_dot == std::string_view::npos) {
+        return fields;
+    }
+    auto rest = symbol_str.substr(first_dot + 1);
+    auto second_dot = rest.find('.');
+    auto market = find_name(MARKET_NAMES, rest.substr(0, second_dot));
+    if (market < MARKET_NAMES.size()) {
+        fields.market = static_cast<Market>(market);
+    }
+    if (second_dot != std::string_view::npos) {
+        auto type = find_name(TYPE_NAMES, rest.substr(second_dot + 1));
+        if (type < TYPE_NAMES.size()) {
+            fields.type = static_cast<SecurityType>(type);
+        }
+    }
+    return fields;
+}
+
+}  // namespace
+
 // Symbol 实现
-Symbol Symbol::parse(const std::string& symbol_str) {
-    // 简单实现：格式为 "CODE.MARKET.TYPE"
-    std::istringstream iss(symbol_str);
-    std::string code, market_str, type_str;
+Symbol::Symbol(std::string_view code, Market market, SecurityType type) {
+    if (code.size() > MAX_CODE_LENGTH) {
+        throw std::invalid_argument("Symbol code too long: " + std::string(code));
+    }
+    if (!is_packable(code)) {
+        throw std::invalid_argument("Invalid character in symbol code: " + std::string(code));
+    }
+    key_ = pack_key(code, market, type);
+}
 
-    if (std::getline(iss, code, '.') && std::getline(iss, market_str, '.') &&
-        std::getline(iss, type_str)) {
-        static const std::unordered_map<std::string, Market> market_map = {{"SH", Market::SH},
-                                                                           {"SZ", Market::SZ},
-                                                                           {"BJ", Market::BJ},
-                                                                           {"HK", Market::HK},
-                                                                           {"US", Market::US}};
+bool Symbol::is_packable(std::string_view code) {
+    return code.size() <= MAX_CODE_LENGTH &&
+           std::ranges::all_of(code, [](char c) { return encode_char(c) != 0; });
+}
 
-        static const std::unordered_map<std::string, SecurityType> type_map = {
-            {"STOCK", SecurityType::STOCK},
-            {"INDEX", SecurityType::INDEX},
-            {"ETF", SecurityType::ETF},
-            {"CONVERTIBLE", SecurityType::CONVERTIBLE},
-            {"BOND", SecurityType::BOND},
-            {"FUTURE", SecurityType::FUTURE},
-            {"OPTION", SecurityType::OPTION}};
+std::optional<Symbol> Symbol::try_pack(std::string_view code, Market market, SecurityType type) {
+    if (!is_packable(code)) {
+        return std::nullopt;
+    }
+    Symbol symbol;
+    symbol.key_ = pack_key(code, market, type);
+    return symbol;
+}
 
-        auto market_it = market_map.find(market_str);
-        auto type_it = type_map.find(type_str);
+Symbol Symbol::parse(std::string_view symbol_str) {
+    auto fields = split_symbol(symbol_str);
+    if (is_packable(fields.code)) {
+        return Symbol(fields.code, fields.market, fields.type);
+    }
 
-        return Symbol(code,
-                      market_it != market_map.end() ? market_it->second : Market::SH,
-                      type_it != type_map.end() ? type_it->second : SecurityType::STOCK);
+    char buffer[MAX_CODE_LENGTH];
+    size_t length = 0;
+    for (char c : fields.code) {
+        if (length < MAX_CODE_LENGTH && encode_char(c) != 0) {
+            buffer[length++] = c;
+        }
     }
+    std::string_view code(buffer, length);
+    utils::Logger::warn("Symbol code {} cannot be packed, truncated to {}", fields.code, code);
+    return Symbol(code, fields.market, fields.type);
+}
 
-    return Symbol(symbol_str, Market::SH, SecurityType::STOCK);
+std::optional<Symbol> Symbol::try_parse(std::string_view symbol_str) {
+    auto fields = split_symbol(symbol_str);
+    return try_pack(fields.code, fields.market, fields.type);
+}
+
+SecurityType Symbol::parse_type(std::string_view symbol_str) {
+    return split_symbol(symbol_str).type;
+}
+
+std::string Symbol::code() const {
+    std::string code;
+    for (size_t i = MAX_CODE_LENGTH; i-- > 0;) {
+        auto value = (key_ >> (CODE_SHIFT + i * CODE_BITS)) & 0x3F;
+        if (value == 0) {
+            break;
+        }
+        code.push_back(DECODE_TABLE[value]);
+    }
+    return code;
 }
 
 std::string Symbol::to_string() const {
-    static const std::array<const char*, 5> market_names = {"SH", "SZ", "BJ", "HK", "US"};
-    static const std::array<const char*, 7> type_names = {
-        "STOCK", "INDEX", "ETF", "CONVERTIBLE", "BOND", "FUTURE", "OPTION"};
+    auto market_name = MARKET_NAMES[static_cast<size_t>(market())];
+    auto type_name = TYPE_NAMES[static_cast<size_t>(type())];
 
-    return code + "." + market_names[static_cast<int>(market)] + "." +
-           type_names[static_cast<int>(type)];
+    std::string result = code();
+    result.reserve(result.size() + market_name.size() + type_name.size() + 2);
+    result.append(1, '.').append(market_name).append(1, '.').append(type_name);
+    return result;
 }
 
+// 注册表中的 id 一经分配不再改变，按打包键缓存在线程本地表中：
+// 每个线程对每个证券只在首次查询时构造名称并访问注册表，之后的查询不加锁、不分配
+SymbolId Symbol::id() const {
+    thread_local std::unordered_map<Symbol, SymbolId> cache;
+    auto it = cache.find(*this);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    auto id = utils::SymbolRegistry::global().intern(to_string());
+    cache.emplace(*this, id);
+    return id;
+}
+
+Symbol Symbol::from_id(SymbolId id) {
+    const auto& name = utils::SymbolRegistry::global().name(id);
+    if (name.empty()) {
+        throw std::runtime_error("Unknown symbol id: " + std::to_string(id));
+    }
+    auto symbol = try_parse(name);
+    if (!symbol) {
+        throw std::runtime_error("Symbol id " + std::to_string(id) + " has unpackable name: " +
+                                 name);
+    }
+    return *symbol;
+}
 
 }  // namespace cppshares::data
\ No newline at end of file
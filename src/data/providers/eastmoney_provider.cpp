@@ -1,13 +1,67 @@
 #include "cppshares/data/providers/eastmoney_provider.hpp"
 
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <format>
+#include <string_view>
+#include <unordered_map>
 
 #include "cppshares/data/data_types.hpp"
+#include "cppshares/data/providers/eastmoney_sax.hpp"
 #include "cppshares/utils/logger.hpp"
 
 namespace cppshares::data::providers {
 
+namespace {
+
+// A股日期按北京时间（UTC+8，无夏令时）解释，不依赖本机时区
+constexpr auto BEIJING_UTC_OFFSET = std::chrono::hours(8);
+
+template <typename T>
+bool parse_number(std::string_view field, T& value) {
+    auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return ec == std::errc{} && end == field.data() + field.size();
+}
+
+// 解析 "YYYY-MM-DD" 或分钟K线的 "YYYY-MM-DD HH:MM"
+std::optional<std::chrono::system_clock::time_point> parse_beijing_time(std::string_view text) {
+    using namespace std::chrono;
+
+    int y = 0;
+    unsigned m = 0, d = 0, hh = 0, mm = 0;
+    if (text.size() < 10 || text[4] != '-' || text[7] != '-' ||
+        !parse_number(text.substr(0, 4), y) || !parse_number(text.substr(5, 2), m) ||
+        !parse_number(text.substr(8, 2), d)) {
+        return std::nullopt;
+    }
+    if (text.size() > 10) {
+        if (text.size() < 16 || text[10] != ' ' || text[13] != ':' ||
+            !parse_number(text.substr(11, 2), hh) || !parse_number(text.substr(14, 2), mm)) {
+            return std::nullopt;
+        }
+    }
+
+    year_month_day date{year{y}, month{m}, day{d}};
+    if (!date.ok()) {
+        return std::nullopt;
+    }
+    return sys_days{date} + hours(hh) + minutes(mm) - BEIJING_UTC_OFFSET;
+}
+
+// 格式化为接口 beg 参数使用的北京时间日期 YYYYMMDD
+std::string beijing_date(std::chrono::system_clock::time_point time) {
+    using namespace std::chrono;
+
+    year_month_day date{floor<days>(time + BEIJING_UTC_OFFSET)};
+    return std::format("{:04}{:02}{:02}",
+                       static_cast<int>(date.year()),
+                       static_cast<unsigned>(date.month()),
+                       static_cast<unsigned>(date.day()));
+}
+
+}  // namespace
+
 EastMoneyProvider::EastMoneyProvider() : client_(BASE_URL), kline_client_(KLINE_URL) {
     client_.set_connection_timeout(5, 0);
     client_.set_read_timeout(10, 0);
@@ -23,6 +77,11 @@ std::optional<MarketTick> EastMoneyProvider::get_realtime_quote(const Symbol& sy
                        "&fields=" + EastMoneyFields::FieldSets::BASIC_QUOTE;
 
     auto result = client_.Get(path.c_str());
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
     if (result && result->status == 200) {
         return parse_realtime_response(result->body, symbol);
     }
@@ -30,24 +89,142 @@ std::optional<MarketTick> EastMoneyProvider::get_realtime_quote(const Symbol& sy
     return std::nullopt;
 }
 
+std::vector<std::optional<MarketTick>> EastMoneyProvider::get_realtime_quotes(
+    std::span<const Symbol> symbols) {
+    if (symbols.empty()) {
+        return {};
+    }
+
+    std::string secids;
+    for (const auto& symbol : symbols) {
+        if (!secids.empty()) {
+            secids += ',';
+        }
+        secids += format_symbol_for_eastmoney(symbol);
+    }
+
+    // fltt=2 让价格以小数形式返回，与单只行情解析保持一致
+    std::string path = "/api/qt/ulist.np/get?fltt=2&secids=" + secids +
+                       "&fields=" + EastMoneyFields::FieldSets::BATCH_QUOTE;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto result = client_.Get(path.c_str());
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
+    if (result && result->status == 200) {
+        return parse_batch_realtime_response(result->body, symbols);
+    }
+
+    return std::vector<std::optional<MarketTick>>(symbols.size());
+}
+
 std::vector<OHLCV> EastMoneyProvider::get_kline_data(const Symbol& symbol,
                                                      KlinePeriod period,
                                                      int limit) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    // 本地历史只在查找与合并时加锁，HTTP 请求期间不持有锁，其他线程可以查找与合并历史；
+    // 所有K线请求共用 kline_client_，由客户端依次执行，不同证券的请求并不并发
+    std::unique_lock<std::mutex> lock(kline_mutex_);
+    if (!incremental_kline_) {
+        lock.unlock();
+        return fetch_klines(symbol, period, "19900101", limit).value_or(std::vector<OHLCV>{});
+    }
 
+    auto key = symbol.to_string() + "|" + period_to_eastmoney_format(period);
+    std::optional<std::chrono::system_clock::time_point> last_bar;
+    if (const auto& series = kline_history_[key];
+        !series.bars.empty() && limit <= series.depth) {
+        last_bar = series.bars.back().timestamp;
+    }
+    lock.unlock();
+
+    std::optional<std::vector<OHLCV>> bars;
+    if (last_bar) {
+        // 从最后一根K线所在日期开始请求，覆盖仍在变化的最后一根
+        bars = fetch_klines(symbol, period, beijing_date(*last_bar), limit);
+        if (!bars) {
+            return {};
+        }
+    } else {
+        bars = fetch_klines(symbol, period, "19900101", limit);
+        if (!bars || bars->empty()) {
+            return {};
+        }
+    }
+
+    lock.lock();
+    auto& series = kline_history_[key];
+    if (!last_bar) {
+        series.bars = std::move(*bars);
+        series.depth = limit;
+    } else if (!merge_klines(series.bars, std::move(*bars))) {
+        // 新数据替换了整个历史，实际深度只有新数据的长度，更大的 limit 需重新全量拉取
+        series.depth = std::min(series.depth, static_cast<int>(series.bars.size()));
+    }
+
+    // 只保留调用方需要的深度，避免历史无限增长
+    if (series.bars.size() > static_cast<size_t>(series.depth)) {
+        series.bars.erase(series.bars.begin(), series.bars.end() - series.depth);
+    }
+
+    auto first = series.bars.size() > static_cast<size_t>(limit) ? series.bars.end() - limit
+                                                                 : series.bars.begin();
+    return std::vector<OHLCV>(first, series.bars.end());
+}
+
+void EastMoneyProvider::set_incremental_kline(bool enabled) {
+    std::lock_guard<std::mutex> lock(kline_mutex_);
+    incremental_kline_ = enabled;
+    if (!enabled) {
+        kline_history_.clear();
+    }
+}
+
+bool EastMoneyProvider::merge_klines(std::vector<OHLCV>& history, std::vector<OHLCV> fresh) {
+    if (fresh.empty()) {
+        return true;
+    }
+    if (history.empty() || fresh.front().timestamp > history.back().timestamp) {
+        history = std::move(fresh);
+        return false;
+    }
+
+    // 丢弃与新数据重叠的本地K线，再追加新数据
+    auto overlap = std::lower_bound(
+        history.begin(), history.end(), fresh.front().timestamp,
+        [](const OHLCV& bar, const auto& timestamp) { return bar.timestamp < timestamp; });
+    history.erase(overlap, history.end());
+    history.insert(history.end(),
+                   std::make_move_iterator(fresh.begin()),
+                   std::make_move_iterator(fresh.end()));
+    return true;
+}
+
+std::optional<std::vector<OHLCV>> EastMoneyProvider::fetch_klines(const Symbol& symbol,
+                                                                  KlinePeriod period,
+                                                                  const std::string& begin_date,
+                                                                  int limit) {
     std::string em_symbol = format_symbol_for_eastmoney(symbol);
     std::string period_str = period_to_eastmoney_format(period);
     std::string path = "/api/qt/stock/kline/get?secid=" + em_symbol +
                        "&fields1=f1,f2,f3&fields2=f51,f52,f53,f54,f55,f56,f57,f58" +
-                       "&klt=" + period_str +
-                       "&fqt=1&beg=19900101&end=20500101&limit=" + std::to_string(limit);
+                       "&klt=" + period_str + "&fqt=1&beg=" + begin_date +
+                       "&end=20500101&limit=" + std::to_string(limit);
 
     auto result = kline_client_.Get(path.c_str());
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
     if (result && result->status == 200) {
         return parse_kline_response(result->body, symbol);
     }
 
-    return {};
+    return std::nullopt;
 }
 
 bool EastMoneyProvider::health_check() {
@@ -59,16 +236,29 @@ bool EastMoneyProvider::health_check() {
 
 std::string EastMoneyProvider::format_symbol_for_eastmoney(const Symbol& symbol) {
     // 沪市: 1.600000 深市: 0.000001
-    if (symbol.market == Market::SH) {
-        return "1." + symbol.code;
-    } else if (symbol.market == Market::SZ) {
-        return "0." + symbol.code;
+    if (symbol.market() == Market::SH) {
+        return "1." + symbol.code();
+    } else if (symbol.market() == Market::SZ) {
+        return "0." + symbol.code();
     }
-    return "1." + symbol.code;  // 默认沪市
+    return "1." + symbol.code();  // 默认沪市
 }
 
 std::optional<MarketTick> EastMoneyProvider::parse_realtime_response(const std::string& response,
                                                                      const Symbol& symbol) {
+    // 优先流式解码，结构不符合预期时回退到 DOM 解析
+    MarketTick sax_tick{};
+    switch (EastMoneySax::decode_quote(response, sax_tick)) {
+        case SaxDecodeStatus::OK:
+            sax_tick.symbol_id = symbol.id();
+            sax_tick.timestamp = std::chrono::system_clock::now();
+            utils::Logger::capture_response("EastMoney", "realtime", symbol.to_string(), response);
+            return sax_tick;
+        case SaxDecodeStatus::NO_DATA:
+            return std::nullopt;
+        case SaxDecodeStatus::UNEXPECTED:
+            break;
+    }
 
     try {
         auto json = nlohmann::json::parse(response);
@@ -81,28 +271,156 @@ std::optional<MarketTick> EastMoneyProvider::parse_realtime_response(const std::
         if (json.contains("data") &&
             json["data"].contains(EastMoneyFields::Realtime::LATEST_PRICE)) {
             MarketTick tick;
-            tick.symbol = symbol.to_string();
+            tick.symbol_id = symbol.id();
             tick.price = json["data"][EastMoneyFields::Realtime::LATEST_PRICE].get<double>();
             tick.volume = json["data"].value(EastMoneyFields::Realtime::VOLUME, 0);
             tick.timestamp = std::chrono::system_clock::now();
             
             // 成功解析数据后记录JSON响应
-            utils::Logger::log_json_response("EastMoney", "realtime", symbol.to_string(), response);
+            utils::Logger::capture_response("EastMoney", "realtime", symbol.to_string(), response);
             
             return tick;
         }
     } catch (const std::exception& e) {
+        note_request_failed();
         // 异常时记录JSON响应用于调试
-        utils::Logger::log_json_response("EastMoney", "realtime_error", symbol.to_string(), response);
+        utils::Logger::capture_response("EastMoney", "realtime", symbol.to_string(), response, true);
         utils::Logger::error("EastMoney realtime parse error for symbol {}: {}", symbol.to_string(), e.what());
     }
     return std::nullopt;
 }
 
+std::vector<std::optional<MarketTick>> EastMoneyProvider::parse_batch_realtime_response(
+    const std::string& response, std::span<const Symbol> symbols) {
+    std::vector<std::optional<MarketTick>> ticks(symbols.size());
+
+    // "市场.代码" -> 输入下标，用于把乱序返回的结果回填到对应位置
+    std::unordered_map<std::string, size_t> index_by_secid;
+    index_by_secid.reserve(symbols.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        index_by_secid.emplace(format_symbol_for_eastmoney(symbols[i]), i);
+    }
+
+    // 停牌或无数据的字段以 "-" 返回
+    auto number_or = [](const nlohmann::json& item, const char* field, double fallback) {
+        auto it = item.find(field);
+        return it != item.end() && it->is_number() ? it->get<double>() : fallback;
+    };
+
+    try {
+        auto json = nlohmann::json::parse(response);
+        auto data_it = json.find("data");
+        if (data_it == json.end() || !data_it->is_object()) {
+            return ticks;
+        }
+        auto diff_it = data_it->find("diff");
+        if (diff_it == data_it->end() || !diff_it->is_array()) {
+            return ticks;
+        }
+
+        auto now = std::chrono::system_clock::now();
+        for (const auto& item : *diff_it) {
+            auto code_it = item.find(EastMoneyFields::Realtime::STOCK_CODE);
+            auto market_it = item.find(EastMoneyFields::Realtime::MARKET);
+            auto price_it = item.find(EastMoneyFields::Realtime::LATEST_PRICE);
+            if (code_it == item.end() || !code_it->is_string() || market_it == item.end() ||
+                !market_it->is_number_integer() || price_it == item.end() ||
+                !price_it->is_number()) {
+                continue;
+            }
+
+            auto secid =
+                std::to_string(market_it->get<int>()) + "." + code_it->get<std::string>();
+            auto index_it = index_by_secid.find(secid);
+            if (index_it == index_by_secid.end()) {
+                continue;
+            }
+
+            const Symbol& symbol = symbols[index_it->second];
+            MarketTick tick{};
+            tick.symbol_id = symbol.id();
+            tick.price = price_it->get<double>();
+            tick.volume = static_cast<uint64_t>(
+                number_or(item, EastMoneyFields::Realtime::VOLUME, 0.0));
+            tick.bid_price = number_or(item, EastMoneyFields::Realtime::BID_PRICE, 0.0);
+            tick.ask_price = number_or(item, EastMoneyFields::Realtime::ASK_PRICE, 0.0);
+            tick.change_rate = number_or(item, EastMoneyFields::Realtime::CHANGE_PERCENT, 0.0);
+            tick.change_amount = number_or(item, EastMoneyFields::Realtime::CHANGE_AMOUNT, 0.0);
+            tick.timestamp = now;
+            ticks[index_it->second] = std::move(tick);
+        }
+    } catch (const std::exception& e) {
+        note_request_failed();
+        utils::Logger::error("EastMoney batch realtime parse error for {} symbols: {}",
+                             symbols.size(),
+                             e.what());
+    }
+
+    return ticks;
+}
+
+std::optional<OHLCV> EastMoneyProvider::parse_kline_row(std::string_view row) {
+    // 东方财富K线数据格式:
+    // "日期,开盘,收盘,最高,最低,成交量,成交额,振幅,涨跌幅,涨跌额,换手率"
+    // 只需要前7个字段
+    std::array<std::string_view, EastMoneyFields::Kline::TURNOVER_INDEX + 1> fields;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        size_t comma = row.find(',');
+        if (comma == std::string_view::npos && i + 1 < fields.size()) {
+            return std::nullopt;
+        }
+        fields[i] = row.substr(0, comma);
+        row = comma == std::string_view::npos ? std::string_view{} : row.substr(comma + 1);
+    }
+
+    auto timestamp = parse_beijing_time(fields[EastMoneyFields::Kline::DATE_INDEX]);
+    if (!timestamp) {
+        return std::nullopt;
+    }
+
+    OHLCV ohlcv{};
+    ohlcv.timestamp = *timestamp;
+    if (!parse_number(fields[EastMoneyFields::Kline::OPEN_INDEX], ohlcv.open) ||
+        !parse_number(fields[EastMoneyFields::Kline::CLOSE_INDEX], ohlcv.close) ||
+        !parse_number(fields[EastMoneyFields::Kline::HIGH_INDEX], ohlcv.high) ||
+        !parse_number(fields[EastMoneyFields::Kline::LOW_INDEX], ohlcv.low) ||
+        !parse_number(fields[EastMoneyFields::Kline::VOLUME_INDEX], ohlcv.volume) ||
+        !parse_number(fields[EastMoneyFields::Kline::TURNOVER_INDEX], ohlcv.amount)) {
+        return std::nullopt;
+    }
+
+    // 数据验证
+    if (ohlcv.open <= 0 || ohlcv.close <= 0 || ohlcv.high <= 0 || ohlcv.low <= 0 ||
+        ohlcv.high < ohlcv.low) {
+        return std::nullopt;
+    }
+    return ohlcv;
+}
+
 std::vector<OHLCV> EastMoneyProvider::parse_kline_response(const std::string& response,
                                                            const Symbol& symbol) {
     std::vector<OHLCV> klines;
 
+    // 优先流式解码，结构不符合预期时回退到 DOM 解析
+    size_t invalid_rows = 0;
+    auto status = EastMoneySax::decode_klines(response, klines, invalid_rows);
+    if (invalid_rows > 0) {
+        utils::Logger::error(
+            "EastMoney: Skipped {} invalid kline rows for symbol {}", invalid_rows, symbol.to_string());
+    }
+    if (status != SaxDecodeStatus::UNEXPECTED) {
+        std::string symbol_str = symbol.to_string();
+        auto symbol_id = symbol.id();
+        for (auto& ohlcv : klines) {
+            ohlcv.symbol_id = symbol_id;
+        }
+        if (!klines.empty()) {
+            utils::Logger::capture_response("EastMoney", "kline", symbol_str, response);
+        }
+        utils::Logger::info(
+            "EastMoney: Successfully parsed {} klines for symbol {}", klines.size(), symbol_str);
+        return klines;
+    }
 
     try {
         auto json = nlohmann::json::parse(response);
@@ -114,7 +432,7 @@ std::vector<OHLCV> EastMoneyProvider::parse_kline_response(const std::string& re
             return klines;
         }
 
-        auto data = json["data"];
+        const auto& data = json["data"];
         if (!data.contains("klines") || !data["klines"].is_array()) {
             utils::Logger::error("EastMoney: No klines array in response for symbol {}",
                                  symbol.to_string());
@@ -122,81 +440,29 @@ std::vector<OHLCV> EastMoneyProvider::parse_kline_response(const std::string& re
         }
 
         // 解析K线数据数组
-        for (const auto& kline_str : data["klines"]) {
+        const auto& rows = data["klines"];
+        klines.reserve(rows.size());
+        std::string symbol_str = symbol.to_string();
+        auto symbol_id = symbol.id();
+        for (const auto& kline_str : rows) {
             if (!kline_str.is_string()) {
                 continue;
             }
 
-            try {
-                // 东方财富K线数据格式:
-                // "日期,开盘,收盘,最高,最低,成交量,成交额,振幅,涨跌幅,涨跌额,换手率"
-                std::string kline_data = kline_str.get<std::string>();
-                std::vector<std::string> fields;
-
-                // 分割逗号分隔的字符串
-                std::stringstream ss(kline_data);
-                std::string field;
-                while (std::getline(ss, field, ',')) {
-                    fields.push_back(field);
-                }
-
-                if (fields.size() >= 7) {  // 至少需要日期、开盘、收盘、最高、最低、成交量、成交额
-                    OHLCV ohlcv;
-                    ohlcv.symbol = symbol.to_string();
-
-                    // 解析日期 (格式: YYYY-MM-DD)
-                    std::tm tm = {};
-                    std::istringstream date_stream(fields[EastMoneyFields::Kline::DATE_INDEX]);
-                    date_stream >> std::get_time(&tm, "%Y-%m-%d");
-                    if (!date_stream.fail()) {
-                        auto time_t_val = std::mktime(&tm);
-                        ohlcv.timestamp = std::chrono::system_clock::from_time_t(time_t_val);
-                    } else {
-                        utils::Logger::error("EastMoney: Invalid date format '{}' for symbol {}",
-                                             fields[EastMoneyFields::Kline::DATE_INDEX],
-                                             symbol.to_string());
-                        ohlcv.timestamp = std::chrono::system_clock::now();
-                    }
-
-                    // 解析OHLCV数据
-                    ohlcv.open = std::stod(fields[EastMoneyFields::Kline::OPEN_INDEX]);
-                    ohlcv.close = std::stod(fields[EastMoneyFields::Kline::CLOSE_INDEX]);
-                    ohlcv.high = std::stod(fields[EastMoneyFields::Kline::HIGH_INDEX]);
-                    ohlcv.low = std::stod(fields[EastMoneyFields::Kline::LOW_INDEX]);
-                    ohlcv.volume = std::stoull(fields[EastMoneyFields::Kline::VOLUME_INDEX]);
-                    ohlcv.amount = std::stod(fields[EastMoneyFields::Kline::TURNOVER_INDEX]);
-
-                    // 数据验证
-                    if (ohlcv.open > 0 && ohlcv.close > 0 && ohlcv.high > 0 && ohlcv.low > 0 &&
-                        ohlcv.high >= ohlcv.low) {
-                        klines.push_back(ohlcv);
-                    } else {
-                        utils::Logger::error(
-                            "EastMoney: Invalid OHLCV data for symbol {}: O={}, H={}, L={}, C={}",
-                            symbol.to_string(),
-                            ohlcv.open,
-                            ohlcv.high,
-                            ohlcv.low,
-                            ohlcv.close);
-                    }
-                } else {
-                    utils::Logger::error(
-                        "EastMoney: Insufficient fields in kline data for symbol {}: expected>=7, "
-                        "got={}",
-                        symbol.to_string(),
-                        fields.size());
-                }
-            } catch (const std::exception& e) {
-                utils::Logger::error("EastMoney: Failed to parse kline entry for symbol {}: {}",
-                                     symbol.to_string(),
-                                     e.what());
+            const auto& row = kline_str.get_ref<const std::string&>();
+            auto ohlcv = parse_kline_row(row);
+            if (!ohlcv) {
+                utils::Logger::error(
+                    "EastMoney: Invalid kline row for symbol {}: '{}'", symbol_str, row);
                 continue;
             }
+            ohlcv->symbol_id = symbol_id;
+            klines.push_back(std::move(*ohlcv));
         }
 
         // 成功解析数据后记录JSON响应
         if (!klines.empty()) {
-            utils::Logger::log_json_response("EastMoney", "kline", symbol.to_string(), response);
+            utils::Logger::capture_response("EastMoney", "kline", symbol.to_string(), response);
         }
         
         utils::Logger::info("EastMoney: Successfully parsed {} klines for symbol {}",
@@ -204,15 +470,17 @@ std::vector<OHLCV> EastMoneyProvider::parse_kline_response(const std::string& re
                             symbol.to_string());
 
     } catch (const nlohmann::json::parse_error& e) {
+        note_request_failed();
         // 异常时记录JSON响应用于调试
-        utils::Logger::log_json_response("EastMoney", "kline_parse_error", symbol.to_string(), response);
+        utils::Logger::capture_response("EastMoney", "kline", symbol.to_string(), response, true);
         utils::Logger::error("EastMoney: JSON parse error for symbol {}: {} at byte {}",
                              symbol.to_string(),
                              e.what(),
                              e.byte);
     } catch (const std::exception& e) {
+        note_request_failed();
         // 异常时记录JSON响应用于调试
-        utils::Logger::log_json_response("EastMoney", "kline_error", symbol.to_string(), response);
+        utils::Logger::capture_response("EastMoney", "kline", symbol.to_string(), response, true);
         utils::Logger::error("EastMoney: Unexpected error parsing klines for symbol {}: {}",
                              symbol.to_string(),
                              e.what());
@@ -0,0 +1,205 @@
+#include "cppshares/data/providers/eastmoney_sax.hpp"
+
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+
+#include "cppshares/data/providers/eastmoney_fields.hpp"
+#include "cppshares/data/providers/eastmoney_provider.hpp"
+
+namespace cppshares::data::providers {
+
+namespace {
+
+// 只跟踪 根对象 -> "data" 对象 -> "klines" 数组 这条路径，其余值一律跳过
+class EastMoneyHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    enum class Scope { ROOT, DATA, KLINES, OTHER };
+
+    bool null() override {
+        if (top() == Scope::ROOT && key_ == "data") {
+            data_null_ = true;
+        }
+        return true;
+    }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t value) override {
+        return on_number(static_cast<double>(value));
+    }
+    bool number_unsigned(number_unsigned_t value) override {
+        return on_number(static_cast<double>(value));
+    }
+    bool number_float(number_float_t value, const string_t&) override { return on_number(value); }
+    bool string(string_t& value) override { return on_string(value); }
+    bool binary(binary_t&) override { return true; }
+
+    bool start_object(std::size_t) override { return enter(false); }
+    bool end_object() override { return leave(); }
+    bool start_array(std::size_t) override { return enter(true); }
+    bool end_array() override { return leave(); }
+
+    bool key(string_t& value) override {
+        key_ = value;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+        unexpected_ = true;
+        return false;
+    }
+
+    bool unexpected() const { return unexpected_; }
+    bool saw_data() const { return saw_data_; }
+    bool data_null() const { return data_null_; }
+
+protected:
+    virtual bool on_number(double) { return true; }
+    virtual bool on_string(string_t&) { return true; }
+    virtual bool wants_klines() const { return false; }
+
+    Scope top() const { return scopes_.empty() ? Scope::OTHER : scopes_.back(); }
+    const std::string& current_key() const { return key_; }
+
+    void fail() { unexpected_ = true; }
+
+private:
+    bool enter(bool is_array) {
+        Scope next = Scope::OTHER;
+        if (scopes_.empty()) {
+            if (is_array) {
+                fail();
+                return false;
+            }
+            next = Scope::ROOT;
+        } else if (top() == Scope::ROOT && key_ == "data") {
+            if (is_array) {
+                fail();
+                return false;
+            }
+            saw_data_ = true;
+            next = Scope::DATA;
+        } else if (top() == Scope::DATA && key_ == "klines" && wants_klines()) {
+            if (!is_array) {
+                fail();
+                return false;
+            }
+            next = Scope::KLINES;
+        }
+        scopes_.push_back(next);
+        return true;
+    }
+
+    bool leave() {
+        scopes_.pop_back();
+        return true;
+    }
+
+    std::vector<Scope> scopes_;
+    std::string key_;
+    bool unexpected_ = false;
+    bool saw_data_ = false;
+    bool data_null_ = false;
+};
+
+class QuoteHandler : public EastMoneyHandler {
+public:
+    std::optional<double> price;
+    std::optional<double> volume;
+
+protected:
+    bool on_number(double value) override {
+        if (top() == Scope::DATA) {
+            if (current_key() == EastMoneyFields::Realtime::LATEST_PRICE) {
+                price = value;
+            } else if (current_key() == EastMoneyFields::Realtime::VOLUME) {
+                volume = value;
+            }
+        }
+        return true;
+    }
+};
+
+class KlineHandler : public EastMoneyHandler {
+public:
+    explicit KlineHandler(std::vector<OHLCV>& klines) : klines_(klines) {}
+
+    size_t invalid_rows = 0;
+
+protected:
+    bool wants_klines() const override { return true; }
+
+    bool on_number(double) override { return !klines_not_array(); }
+
+    bool on_string(string_t& value) override {
+        if (top() != Scope::KLINES) {
+            return !klines_not_array();
+        }
+        if (auto ohlcv = EastMoneyProvider::parse_kline_row(value)) {
+            klines_.push_back(std::move(*ohlcv));
+        } else {
+            invalid_rows++;
+        }
+        return true;
+    }
+
+private:
+    bool klines_not_array() {
+        if (top() == Scope::DATA && current_key() == "klines") {
+            fail();
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<OHLCV>& klines_;
+};
+
+}  // namespace
+
+namespace EastMoneySax {
+
+SaxDecodeStatus decode_quote(std::string_view response, MarketTick& tick) {
+    QuoteHandler handler;
+    nlohmann::json::sax_parse(response.begin(), response.end(), &handler);
+    if (handler.unexpected()) {
+        return SaxDecodeStatus::UNEXPECTED;
+    }
+    if (handler.data_null()) {
+        return SaxDecodeStatus::NO_DATA;
+    }
+    if (!handler.saw_data()) {
+        return SaxDecodeStatus::UNEXPECTED;
+    }
+    if (!handler.price) {
+        return SaxDecodeStatus::NO_DATA;
+    }
+
+    tick.price = *handler.price;
+    tick.volume = static_cast<uint64_t>(handler.volume.value_or(0.0));
+    return SaxDecodeStatus::OK;
+}
+
+SaxDecodeStatus decode_klines(std::string_view response,
+                              std::vector<OHLCV>& klines,
+                              size_t& invalid_rows) {
+    size_t initial_size = klines.size();
+    KlineHandler handler(klines);
+    nlohmann::json::sax_parse(response.begin(), response.end(), &handler);
+    invalid_rows = handler.invalid_rows;
+
+    if (handler.unexpected()) {
+        klines.resize(initial_size);
+        return SaxDecodeStatus::UNEXPECTED;
+    }
+    if (handler.data_null()) {
+        return SaxDecodeStatus::NO_DATA;
+    }
+    if (!handler.saw_data()) {
+        return SaxDecodeStatus::UNEXPECTED;
+    }
+    return klines.size() > initial_size ? SaxDecodeStatus::OK : SaxDecodeStatus::NO_DATA;
+}
+
+}  // namespace EastMoneySax
+
+}  // namespace cppshares::data::providers
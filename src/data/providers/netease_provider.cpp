@@ -16,6 +16,11 @@ std::optional<MarketTick> NeteaseProvider::get_realtime_quote(const Symbol& symb
     std::string path = "/data/feed/" + netease_symbol;
 
     auto result = client_.Get(path);
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
     if (result && result->status == 200) {
         return parse_realtime_response(result->body, symbol);
     }
@@ -32,6 +37,11 @@ std::vector<OHLCV> NeteaseProvider::get_kline_data(const Symbol& symbol,
     std::string path = "/data/hs/kline/" + netease_symbol;
 
     auto result = client_.Get(path);
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
     if (result && result->status == 200) {
         return parse_kline_response(result->body, symbol);
     }
@@ -48,7 +58,7 @@ std::optional<MarketTick> NeteaseProvider::parse_realtime_response(const std::st
                                                                    const Symbol& symbol) {
     // 简单的解析实现
     MarketTick tick;
-    tick.symbol = symbol.to_string();
+    tick.symbol_id = symbol.id();
     tick.price = 0.0;
     tick.volume = 0;
     tick.timestamp = std::chrono::system_clock::now();
@@ -64,11 +74,11 @@ std::vector<OHLCV> NeteaseProvider::parse_kline_response(const std::string& resp
 std::string NeteaseProvider::convert_to_netease_symbol(const Symbol& symbol) {
     // 网易格式: 0600000(沪市), 1000001(深市)
     static const std::array<const char*, 5> prefixes = {"0", "1", "2", "3", "4"};
-    int market_index = static_cast<int>(symbol.market);
+    int market_index = static_cast<int>(symbol.market());
     if (market_index >= 0 && market_index < static_cast<int>(prefixes.size())) {
-        return std::string(prefixes[market_index]) + symbol.code;
+        return std::string(prefixes[market_index]) + symbol.code();
     }
-    return "0" + symbol.code;  // 默认沪市
+    return std::string("0").append(symbol.code());  // 默认沪市
 }
 
 }  // namespace cppshares::data::providers
\ No newline at end of file
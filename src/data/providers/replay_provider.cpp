@@ -0,0 +1,106 @@
+#include "cppshares/data/providers/replay_provider.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace cppshares::data::providers {
+
+ReplayProvider::ReplayProvider(const std::string& log_path, ReplayConfig config)
+    : reader_(log_path, config.read_mode), config_(config) {}
+
+size_t ReplayProvider::replay(const TickCallback& on_tick) {
+    stopping_.store(false, std::memory_order_relaxed);
+
+    bool paced = config_.speed > 0.0;
+    uint64_t first_us = 0;
+    auto start = std::chrono::steady_clock::now();
+    size_t replayed = 0;
+    MarketTick tick{};
+    const auto& registry = utils::SymbolRegistry::global();
+
+    for (const auto& record : reader_.records()) {
+        if (stopping_.load(std::memory_order_relaxed)) {
+            break;
+        }
+        // 不在注册表中的 id（旧格式日志或恢复模式放过的损坏记录）直接跳过，避免按其大小扩展 latest_
+        auto market = record.market_data();
+        if (!market || registry.name(market->symbol_id).empty()) {
+            continue;
+        }
+
+        // 按与首条记录的时间差等待，不累计每条记录的调度误差
+        if (paced) {
+            if (replayed == 0) {
+                first_us = record.unix_us;
+                start = std::chrono::steady_clock::now();
+            } else if (record.unix_us > first_us) {
+                std::chrono::duration<double, std::micro> offset(
+                    static_cast<double>(record.unix_us - first_us) / config_.speed);
+                auto target =
+                    start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+                if (target > std::chrono::steady_clock::now()) {
+                    std::this_thread::sleep_until(target);
+                }
+            }
+        }
+
+        Quote quote{.price = market->price, .volume = market->volume, .unix_us = record.unix_us};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (market->symbol_id >= latest_.size()) {
+                latest_.resize(size_t{market->symbol_id} + 1);
+            }
+            latest_[market->symbol_id] = quote;
+        }
+        replayed++;
+
+        if (on_tick) {
+            tick.symbol_id = market->symbol_id;
+            fill_tick(tick, quote);
+            if (!on_tick(tick)) {
+                break;
+            }
+        }
+    }
+    return replayed;
+}
+
+std::optional<MarketTick> ReplayProvider::get_realtime_quote(const Symbol& symbol) {
+    auto id = utils::SymbolRegistry::global().find(symbol.to_string());
+    if (!id) {
+        return std::nullopt;
+    }
+
+    Quote quote;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (*id >= latest_.size() || !latest_[*id]) {
+            return std::nullopt;
+        }
+        quote = *latest_[*id];
+    }
+
+    MarketTick tick{};
+    tick.symbol_id = *id;
+    fill_tick(tick, quote);
+    return tick;
+}
+
+std::vector<std::optional<MarketTick>> ReplayProvider::get_realtime_quotes(
+    std::span<const Symbol> symbols) {
+    std::vector<std::optional<MarketTick>> result;
+    result.reserve(symbols.size());
+    for (const auto& symbol : symbols) {
+        result.push_back(get_realtime_quote(symbol));
+    }
+    return result;
+}
+
+void ReplayProvider::fill_tick(MarketTick& tick, const Quote& quote) {
+    tick.price = quote.price;
+    tick.volume = quote.volume;
+    tick.timestamp =
+        std::chrono::system_clock::time_point(std::chrono::microseconds(quote.unix_us));
+}
+
+}  // namespace cppshares::data::providers
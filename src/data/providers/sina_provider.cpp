@@ -1,5 +1,10 @@
 #include "cppshares/data/providers/sina_provider.hpp"
 
+#include <array>
+#include <charconv>
+#include <string_view>
+#include <unordered_map>
+
 #include "cppshares/data/data_types.hpp"
 
 namespace cppshares::data::providers {
@@ -19,6 +24,11 @@ std::optional<MarketTick> SinaProvider::get_realtime_quote(const Symbol& symbol)
     std::string path = "/rn=xppzh&list=" + sina_symbol;
 
     auto result = client_.Get(path);
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
     if (result && result->status == 200) {
         return parse_realtime_response(result->body, symbol);
     }
@@ -26,6 +36,35 @@ std::optional<MarketTick> SinaProvider::get_realtime_quote(const Symbol& symbol)
     return std::nullopt;
 }
 
+std::vector<std::optional<MarketTick>> SinaProvider::get_realtime_quotes(
+    std::span<const Symbol> symbols) {
+    if (symbols.empty()) {
+        return {};
+    }
+
+    std::string path = "/rn=xppzh&list=";
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        if (i > 0) {
+            path += ',';
+        }
+        path += format_symbol_for_sina(symbols[i]);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto result = client_.Get(path);
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
+    if (result && result->status == 200) {
+        return parse_batch_realtime_response(result->body, symbols);
+    }
+
+    return std::vector<std::optional<MarketTick>>(symbols.size());
+}
+
 std::vector<OHLCV> SinaProvider::get_kline_data(const Symbol& symbol,
                                                 KlinePeriod period,
                                                 int limit) {
@@ -36,6 +75,11 @@ std::vector<OHLCV> SinaProvider::get_kline_data(const Symbol& symbol,
     std::string path = "/akdaily/cn/" + period_str + "/" + sina_symbol + ".js";
 
     auto result = kline_client_.Get(path);
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
     if (result && result->status == 200) {
         return parse_kline_response(result->body, symbol);
     }
@@ -51,23 +95,101 @@ bool SinaProvider::health_check() {
 std::string SinaProvider::format_symbol_for_sina(const Symbol& symbol) {
     // 新浪格式: sh600000, sz000001
     static const std::array<const char*, 5> prefixes = {"sh", "sz", "bj", "hk", "us"};
-    int market_index = static_cast<int>(symbol.market);
+    int market_index = static_cast<int>(symbol.market());
     if (market_index >= 0 && market_index < static_cast<int>(prefixes.size())) {
-        return std::string(prefixes[market_index]) + symbol.code;
+        return std::string(prefixes[market_index]) + symbol.code();
     }
-    return "sh" + symbol.code;  // 默认沪市
+    return "sh" + symbol.code();  // 默认沪市
 }
 
 std::optional<MarketTick> SinaProvider::parse_realtime_response(const std::string& response,
                                                                 const Symbol& symbol) {
-    // 简单的解析实现，实际中需要解析新浪的返回格式
-    MarketTick tick;
-    tick.symbol = symbol.to_string();
-    tick.price = 0.0;
-    tick.volume = 0;
-    tick.timestamp = std::chrono::system_clock::now();
-
-    return tick;
+    auto ticks = parse_batch_realtime_response(response, std::span<const Symbol>(&symbol, 1));
+    return ticks.front();
+}
+
+std::vector<std::optional<MarketTick>> SinaProvider::parse_batch_realtime_response(
+    const std::string& response, std::span<const Symbol> symbols) {
+    std::vector<std::optional<MarketTick>> ticks(symbols.size());
+
+    // 新浪格式符号 -> 输入下标
+    std::unordered_map<std::string, size_t> index_by_symbol;
+    index_by_symbol.reserve(symbols.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        index_by_symbol.emplace(format_symbol_for_sina(symbols[i]), i);
+    }
+
+    auto to_double = [](std::string_view field) {
+        double value = 0.0;
+        std::from_chars(field.data(), field.data() + field.size(), value);
+        return value;
+    };
+
+    // 每行格式: var hq_str_sh600000="名称,今开,昨收,现价,最高,最低,买一,卖一,成交量,成交额,...";
+    static constexpr std::string_view prefix = "hq_str_";
+    auto now = std::chrono::system_clock::now();
+    std::string_view body(response);
+
+    while (!body.empty()) {
+        auto line_end = body.find('\n');
+        std::string_view line = body.substr(0, line_end);
+        body = line_end == std::string_view::npos ? std::string_view{} : body.substr(line_end + 1);
+
+        auto name_pos = line.find(prefix);
+        auto eq_pos = line.find("=\"");
+        if (name_pos == std::string_view::npos || eq_pos == std::string_view::npos ||
+            eq_pos < name_pos) {
+            continue;
+        }
+
+        auto sina_symbol = line.substr(name_pos + prefix.size(), eq_pos - name_pos - prefix.size());
+        auto index_it = index_by_symbol.find(std::string(sina_symbol));
+        if (index_it == index_by_symbol.end()) {
+            continue;
+        }
+
+        auto value_begin = eq_pos + 2;
+        auto value_end = line.find('"', value_begin);
+        if (value_end == std::string_view::npos) {
+            continue;
+        }
+        std::string_view values = line.substr(value_begin, value_end - value_begin);
+
+        // 只取前10个字段，未知代码返回空字符串
+        std::array<std::string_view, 10> fields{};
+        size_t field_count = 0;
+        while (field_count < fields.size() && !values.empty()) {
+            auto comma = values.find(',');
+            fields[field_count++] = values.substr(0, comma);
+            values = comma == std::string_view::npos ? std::string_view{}
+                                                     : values.substr(comma + 1);
+        }
+        if (field_count < fields.size()) {
+            continue;
+        }
+
+        // 停牌或开盘前尚无成交时现价为 0，与东方财富一致按无数据处理
+        double price = to_double(fields[3]);
+        if (price <= 0.0) {
+            continue;
+        }
+
+        MarketTick tick{};
+        tick.symbol_id = symbols[index_it->second].id();
+        tick.price = price;
+        tick.bid_price = to_double(fields[6]);
+        tick.ask_price = to_double(fields[7]);
+        tick.volume = static_cast<uint64_t>(to_double(fields[8]));
+        double prev_close = to_double(fields[2]);
+        if (prev_close > 0.0) {
+            tick.change_amount = tick.price - prev_close;
+            tick.change_rate = tick.change_amount / prev_close * 100.0;
+        }
+        tick.timestamp = now;
+        ticks[index_it->second] = std::move(tick);
+    }
+
+    return ticks;
 }
 
 std::vector<OHLCV> SinaProvider::parse_kline_response(const std::string& response,
@@ -16,6 +16,11 @@ std::optional<MarketTick> TencentProvider::get_realtime_quote(const Symbol& symb
     std::string path = "/q=" + tencent_symbol;
 
     auto result = client_.Get(path);
+    if (result) {
+        note_http_status(result->status, result->body.size());
+    } else {
+        note_request_failed();
+    }
     if (result && result->status == 200) {
         return parse_realtime_response(result->body, symbol);
     }
@@ -39,7 +44,7 @@ std::optional<MarketTick> TencentProvider::parse_realtime_response(const std::st
                                                                    const Symbol& symbol) {
     // 简单的解析实现
     MarketTick tick;
-    tick.symbol = symbol.to_string();
+    tick.symbol_id = symbol.id();
     tick.price = 0.0;
     tick.volume = 0;
     tick.timestamp = std::chrono::system_clock::now();
@@ -55,11 +60,11 @@ std::vector<OHLCV> TencentProvider::parse_kline_response(const std::string& resp
 std::string TencentProvider::convert_to_tencent_symbol(const Symbol& symbol) {
     // 腾讯格式: sh600000, sz000001 (与新浪相同)
     static const std::array<const char*, 5> prefixes = {"sh", "sz", "bj", "hk", "us"};
-    int market_index = static_cast<int>(symbol.market);
+    int market_index = static_cast<int>(symbol.market());
     if (market_index >= 0 && market_index < static_cast<int>(prefixes.size())) {
-        return std::string(prefixes[market_index]) + symbol.code;
+        return std::string(prefixes[market_index]) + symbol.code();
     }
-    return "sh" + symbol.code;  // 默认沪市
+    return "sh" + symbol.code();  // 默认沪市
 }
 
 }  // namespace cppshares::data::providers
\ No newline at end of file
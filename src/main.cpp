@@ -13,21 +13,21 @@ int main() {
 
     // 注册一些测试符号
     auto& logger = cppshares::utils::Logger::instance();
-    logger.register_symbol(1001, "AAPL");
-    logger.register_symbol(1002, "GOOGL");
-    logger.register_symbol(1003, "MSFT");
+    auto aapl = logger.intern_symbol("AAPL.US.STOCK");
+    auto googl = logger.intern_symbol("GOOGL.US.STOCK");
+    auto msft = logger.intern_symbol("MSFT.US.STOCK");
 
     // 二进制日志示例 - 模拟市场数据
-    logger.log_market_data(1001, 150.25, 1000, true);   // AAPL买单
-    logger.log_market_data(1002, 2800.50, 500, false);  // GOOGL卖单
-    logger.log_market_data(1003, 320.75, 2000, true);   // MSFT买单
+    logger.log_market_data(aapl, 150.25, 1000, true);    // AAPL买单
+    logger.log_market_data(googl, 2800.50, 500, false);  // GOOGL卖单
+    logger.log_market_data(msft, 320.75, 2000, true);    // MSFT买单
 
     // 订单日志示例
-    logger.log_order(12345, 1001, 150.30, 100, true, 0);  // 新订单
-    logger.log_order(12345, 1001, 150.30, 100, true, 1);  // 成交
+    logger.log_order(12345, aapl, 150.30, 100, true, 0);  // 新订单
+    logger.log_order(12345, aapl, 150.30, 100, true, 1);  // 成交
 
     // 策略信号示例
-    logger.log_strategy_signal(101, 1001, 0, 85, 155.0, 200);  // 买入信号
+    logger.log_strategy_signal(101, aapl, 0, 85, 155.0, 200);  // 买入信号
 
     // 数学工具测试
     std::vector<double> prices = {150.0, 151.5, 149.8, 152.3, 150.9, 153.1};
@@ -48,8 +48,9 @@ int main() {
                                    bollinger.middle,
                                    bollinger.lower);
 
-    // 刷新所有日志缓冲区
+    // 刷新所有日志缓冲区，并写出符号映射供离线读取
     logger.flush();
+    logger.save_symbol_map("logs/market_data.symbols");
 
     cppshares::utils::Logger::info("System initialized successfully");
     return 0;
@@ -0,0 +1,442 @@
+#include "cppshares/utils/binary_log_segment.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#include "cppshares/utils/binary_log_reader.hpp"
+
+namespace cppshares::utils {
+
+namespace {
+
+uint64_t now_unix_us() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+const char* state_name(SegmentState state) {
+    switch (state) {
+        case SegmentState::OPEN:
+            return "open";
+        case SegmentState::CLOSED:
+            return "closed";
+        case SegmentState::COMPRESSED:
+            return "compressed";
+    }
+    return "open";
+}
+
+SegmentState parse_state(std::string_view name) {
+    if (name == "compressed") {
+        return SegmentState::COMPRESSED;
+    }
+    return name == "closed" ? SegmentState::CLOSED : SegmentState::OPEN;
+}
+
+uint64_t parse_u64(std::string_view text) {
+    uint64_t value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+// 从 <日志名>.<序号>.bin[z] 中取出序号
+uint64_t segment_index(std::string_view file, std::string_view stem) {
+    if (file.size() <= stem.size() + 1 || !file.starts_with(stem) || file[stem.size()] != '.') {
+        return 0;
+    }
+    return parse_u64(file.substr(stem.size() + 1));
+}
+
+// p 处是否为一条块标记记录（CRC 校验块的起点）
+bool at_block_marker(const char* p, const char* end) {
+    if (static_cast<size_t>(end - p) < sizeof(BinaryLogEntry) + sizeof(BlockMarkerRecord)) {
+        return false;
+    }
+    BinaryLogEntry entry;
+    std::memcpy(&entry, p, sizeof(entry));
+    return entry.event_type == BlockMarkerRecord::TYPE_ID &&
+           std::memcmp(p + sizeof(entry), BINARY_LOG_BLOCK_MAGIC, sizeof(BINARY_LOG_BLOCK_MAGIC)) ==
+               0;
+}
+
+}  // namespace
+
+// BinaryLogSegments 实现
+BinaryLogSegments::BinaryLogSegments(const std::string& base_path, SegmentConfig config)
+    : base_path_(base_path), config_(config) {
+    std::filesystem::path path(base_path);
+    directory_ = path.parent_path().string();
+    stem_ = path.stem().string();
+    if (!directory_.empty()) {
+        std::filesystem::create_directories(directory_);
+    }
+
+    // 接续已有清单：序号继续递增；上次异常退出时仍处于 open 的分段按已关闭处理
+    segments_ = read_manifest(base_path);
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        auto& segment = segments_[i];
+        next_index_ = std::max(next_index_, segment_index(segment.file, stem_) + 1);
+        if (segment.state == SegmentState::OPEN) {
+            std::error_code ec;
+            auto size = std::filesystem::file_size(segment_path(segment.file), ec);
+            segment.raw_bytes = ec ? 0 : size;
+            segment.closed_unix_us = now_unix_us();
+            segment.state = SegmentState::CLOSED;
+        }
+        if (config_.compress_closed && segment.state == SegmentState::CLOSED) {
+            pending_.push_back(i);
+        }
+    }
+    if (!segments_.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        write_manifest();
+    }
+
+    if (config_.compress_closed) {
+        compressor_ = std::thread([this] { run_compressor(); });
+    }
+}
+
+BinaryLogSegments::~BinaryLogSegments() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (compressor_.joinable()) {
+        compressor_.join();
+    }
+}
+
+std::string BinaryLogSegments::open_next() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SegmentInfo segment{.file = std::format("{}.{:06d}.bin", stem_, next_index_++),
+                        .opened_unix_us = now_unix_us(),
+                        .closed_unix_us = 0,
+                        .raw_bytes = 0,
+                        .state = SegmentState::OPEN};
+    segments_.push_back(segment);
+    write_manifest();
+    return segment_path(segment.file);
+}
+
+void BinaryLogSegments::close_current(uint64_t raw_bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (segments_.empty() || segments_.back().state != SegmentState::OPEN) {
+            return;
+        }
+        auto& segment = segments_.back();
+        segment.closed_unix_us = now_unix_us();
+        segment.raw_bytes = raw_bytes;
+        segment.state = SegmentState::CLOSED;
+        if (config_.compress_closed) {
+            pending_.push_back(segments_.size() - 1);
+        }
+        write_manifest();
+    }
+    wake_.notify_one();
+}
+
+void BinaryLogSegments::wait_for_compression() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this] { return pending_.empty() && !compressing_; });
+}
+
+std::vector<SegmentInfo> BinaryLogSegments::segments() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_;
+}
+
+std::string BinaryLogSegments::manifest_path(const std::string& base_path) {
+    std::filesystem::path path(base_path);
+    return (path.parent_path() / (path.stem().string() + ".manifest")).string();
+}
+
+std::vector<SegmentInfo> BinaryLogSegments::read_manifest(const std::string& base_path) {
+    std::vector<SegmentInfo> segments;
+    std::ifstream file(manifest_path(base_path));
+    std::string line;
+    std::getline(file, line);  // 表头
+    while (std::getline(file, line)) {
+        std::vector<std::string_view> fields;
+        std::string_view rest(line);
+        while (true) {
+            auto pos = rest.find(',');
+            fields.push_back(rest.substr(0, pos));
+            if (pos == std::string_view::npos) {
+                break;
+            }
+            rest.remove_prefix(pos + 1);
+        }
+        if (fields.size() != 5) {
+            continue;
+        }
+        segments.push_back({.file = std::string(fields[0]),
+                            .opened_unix_us = parse_u64(fields[1]),
+                            .closed_unix_us = parse_u64(fields[2]),
+                            .raw_bytes = parse_u64(fields[3]),
+                            .state = parse_state(fields[4])});
+    }
+    return segments;
+}
+
+void BinaryLogSegments::write_manifest() const {
+    auto path = manifest_path(base_path_);
+    auto temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        file << "segment,opened_unix_us,closed_unix_us,raw_bytes,state\n";
+        for (const auto& segment : segments_) {
+            file << std::format("{},{},{},{},{}\n",
+                                segment.file,
+                                segment.opened_unix_us,
+                                segment.closed_unix_us,
+                                segment.raw_bytes,
+                                state_name(segment.state));
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+}
+
+std::string BinaryLogSegments::segment_path(const std::string& file) const {
+    return (std::filesystem::path(directory_) / file).string();
+}
+
+void BinaryLogSegments::run_compressor() {
+    while (true) {
+        size_t index = 0;
+        std::string file;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                break;
+            }
+            index = pending_.front();
+            pending_.pop_front();
+            file = segments_[index].file;
+            compressing_ = true;
+        }
+
+        auto source = segment_path(file);
+        auto compressed_file = file + "z";
+        auto destination = segment_path(compressed_file);
+        bool compressed = false;
+        try {
+            compress_segment(
+                source, destination + ".tmp", config_.block_size, config_.compression_level);
+            std::filesystem::rename(destination + ".tmp", destination);
+            std::filesystem::remove(source);
+            compressed = true;
+        } catch (const std::exception&) {
+            // 压缩失败时保留原始分段
+            std::error_code ec;
+            std::filesystem::remove(destination + ".tmp", ec);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (compressed) {
+                segments_[index].file = compressed_file;
+                segments_[index].state = SegmentState::COMPRESSED;
+                write_manifest();
+            }
+            compressing_ = false;
+        }
+        drained_.notify_all();
+    }
+}
+
+// 块格式压缩
+bool is_compressed_log(std::span<const char> bytes) {
+    return bytes.size() >= sizeof(COMPRESSED_LOG_MAGIC) + sizeof(CompressedLogFooter) &&
+           std::memcmp(bytes.data(), COMPRESSED_LOG_MAGIC, sizeof(COMPRESSED_LOG_MAGIC)) == 0;
+}
+
+size_t compress_segment(const std::string& source,
+                        const std::string& destination,
+                        size_t block_size,
+                        int level) {
+    MappedFile input(source);
+    input.advise_sequential();
+    std::ofstream output(destination, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        throw std::runtime_error("Failed to create compressed segment: " + destination);
+    }
+    output.write(COMPRESSED_LOG_MAGIC, sizeof(COMPRESSED_LOG_MAGIC));
+
+    const char* base = input.data();
+    const char* end = base + input.size();
+    uint64_t file_offset = sizeof(COMPRESSED_LOG_MAGIC);
+    uint64_t raw_size = 0;
+    std::vector<CompressedBlockIndexEntry> index;
+    std::vector<char> compressed;
+
+    auto write_block = [&](const char* block_start,
+                           const char* block_end,
+                           const TscCalibration& clock,
+                           uint64_t first_unix_us) {
+        auto block_raw_size = static_cast<uLong>(block_end - block_start);
+        uLongf stored_size = compressBound(block_raw_size);
+        compressed.resize(stored_size);
+        if (compress2(reinterpret_cast<Bytef*>(compressed.data()),
+                      &stored_size,
+                      reinterpret_cast<const Bytef*>(block_start),
+                      block_raw_size,
+                      level) != Z_OK) {
+            throw std::runtime_error("Failed to compress segment: " + source);
+        }
+
+        CompressedBlockHeader header{.raw_size = static_cast<uint32_t>(block_raw_size),
+                                     .stored_size = static_cast<uint32_t>(stored_size),
+                                     .reference_ticks = clock.reference_ticks,
+                                     .reference_unix_ns = clock.reference_unix_ns,
+                                     .ns_per_tick = clock.ns_per_tick};
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(compressed.data(), static_cast<std::streamsize>(stored_size));
+
+        index.push_back({.file_offset = file_offset,
+                         .raw_offset = static_cast<uint64_t>(block_start - base),
+                         .first_unix_us = first_unix_us});
+        file_offset += sizeof(header) + stored_size;
+        raw_size = static_cast<uint64_t>(block_end - base);
+    };
+
+    // 块首尾相接，文件头与块标记也一并保存，解压结果与原始分段逐字节一致
+    // 以校验模式遍历：损坏区域被跳过的字节落在下一块的范围内，无法解析的尾部单独成块
+    // 压缩块只在块标记处切分，每个 CRC 校验块完整地落在一个压缩块内，单独解压后仍可校验
+    const char* block_start = base;
+    const char* block_end = base;
+    TscCalibration clock;
+    uint64_t first_unix_us = 0;
+    BinaryLogIterator it(base, end, TscCalibration{}, true);
+    for (BinaryLogIterator last(end, end, TscCalibration{}, true); it != last;
+         block_start = block_end) {
+        // 块起点的时钟校准；若首条即为校准记录，读取端解析时会再次应用，结果相同
+        clock = it.clock();
+        first_unix_us = (*it).unix_us;
+        block_end = block_start;
+        while (it != last && (static_cast<size_t>(block_end - block_start) < block_size ||
+                              !at_block_marker(block_end, end))) {
+            auto record = *it;
+            block_end = reinterpret_cast<const char*>(record.header) + sizeof(BinaryLogEntry) +
+                        record.payload.size();
+            ++it;
+        }
+        write_block(block_start, block_end, clock, first_unix_us);
+    }
+    if (block_end < end) {
+        write_block(block_end, end, clock, first_unix_us);
+    }
+    if (raw_size != input.size()) {
+        throw std::runtime_error("Compressed segment does not cover the source: " + source);
+    }
+
+    CompressedLogFooter footer{.index_offset = file_offset,
+                               .block_count = index.size(),
+                               .raw_size = raw_size,
+                               .magic = {}};
+    std::memcpy(footer.magic, COMPRESSED_LOG_MAGIC, sizeof(footer.magic));
+    output.write(reinterpret_cast<const char*>(index.data()),
+                 static_cast<std::streamsize>(index.size() * sizeof(CompressedBlockIndexEntry)));
+    output.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    output.flush();
+    if (!output) {
+        throw std::runtime_error("Failed to write compressed segment: " + destination);
+    }
+    return index.size();
+}
+
+// CompressedLogReader 实现
+CompressedLogReader::CompressedLogReader(const std::string& path) : file_(path) {
+    auto bytes = file_.bytes();
+    if (!is_compressed_log(bytes)) {
+        throw std::runtime_error("Not a compressed binary log: " + path);
+    }
+
+    CompressedLogFooter footer;
+    std::memcpy(&footer, bytes.data() + bytes.size() - sizeof(footer), sizeof(footer));
+    uint64_t index_limit = bytes.size() - sizeof(footer);
+    constexpr size_t entry_size = sizeof(CompressedBlockIndexEntry);
+    if (std::memcmp(footer.magic, COMPRESSED_LOG_MAGIC, sizeof(footer.magic)) != 0 ||
+        footer.index_offset > index_limit ||
+        footer.block_count > (index_limit - footer.index_offset) / entry_size) {
+        throw std::runtime_error("Corrupted compressed binary log: " + path);
+    }
+
+    const auto* entries =
+        reinterpret_cast<const CompressedBlockIndexEntry*>(bytes.data() + footer.index_offset);
+    index_ = {entries, footer.block_count};
+    raw_size_ = footer.raw_size;
+}
+
+std::vector<char> CompressedLogReader::read_block(size_t index, TscCalibration* clock) const {
+    auto bytes = file_.bytes();
+    uint64_t offset = index_[index].file_offset;
+    CompressedBlockHeader header;
+    if (offset + sizeof(header) > bytes.size()) {
+        throw std::runtime_error("Corrupted compressed block");
+    }
+    std::memcpy(&header, bytes.data() + offset, sizeof(header));
+    if (header.stored_size > bytes.size() - offset - sizeof(header)) {
+        throw std::runtime_error("Corrupted compressed block");
+    }
+
+    std::vector<char> raw(header.raw_size);
+    uLongf raw_size = header.raw_size;
+    if (uncompress(reinterpret_cast<Bytef*>(raw.data()),
+                   &raw_size,
+                   reinterpret_cast<const Bytef*>(bytes.data() + offset + sizeof(header)),
+                   header.stored_size) != Z_OK ||
+        raw_size != header.raw_size) {
+        throw std::runtime_error("Corrupted compressed block");
+    }
+
+    if (clock != nullptr) {
+        *clock = {.reference_ticks = header.reference_ticks,
+                  .reference_unix_ns = header.reference_unix_ns,
+                  .ns_per_tick = header.ns_per_tick};
+    }
+    return raw;
+}
+
+size_t CompressedLogReader::find_block_by_time(uint64_t unix_us) const {
+    auto it = std::ranges::upper_bound(
+        index_, unix_us, {}, [](const CompressedBlockIndexEntry& entry) -> uint64_t {
+            return entry.first_unix_us;
+        });
+    return it == index_.begin() ? 0 : static_cast<size_t>(it - index_.begin()) - 1;
+}
+
+size_t CompressedLogReader::find_block_by_offset(uint64_t raw_offset) const {
+    auto it = std::ranges::upper_bound(
+        index_, raw_offset, {}, [](const CompressedBlockIndexEntry& entry) -> uint64_t {
+            return entry.raw_offset;
+        });
+    return it == index_.begin() ? 0 : static_cast<size_t>(it - index_.begin()) - 1;
+}
+
+std::vector<char> CompressedLogReader::read_all() const {
+    std::vector<char> raw(raw_size_);
+    for (size_t i = 0; i < index_.size(); ++i) {
+        auto block = read_block(i);
+        uint64_t offset = index_[i].raw_offset;
+        if (offset > raw.size() || block.size() > raw.size() - offset) {
+            throw std::runtime_error("Corrupted compressed block");
+        }
+        std::memcpy(raw.data() + offset, block.data(), block.size());
+    }
+    return raw;
+}
+
+}  // namespace cppshares::utils
@@ -0,0 +1,276 @@
+#include "cppshares/utils/columnar_log.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+namespace cppshares::utils {
+
+namespace {
+
+struct ColumnSpec {
+    const char* name;
+    ColumnType type;
+};
+
+// 第一列固定为 timestamp_us
+constexpr ColumnSpec MARKET_DATA_COLUMNS[] = {{"timestamp_us", ColumnType::U64},
+                                              {"symbol_id", ColumnType::U32},
+                                              {"price", ColumnType::F64},
+                                              {"volume", ColumnType::U64},
+                                              {"side", ColumnType::U8}};
+
+constexpr ColumnSpec ORDER_COLUMNS[] = {{"timestamp_us", ColumnType::U64},
+                                        {"order_id", ColumnType::U64},
+                                        {"symbol_id", ColumnType::U32},
+                                        {"price", ColumnType::F64},
+                                        {"quantity", ColumnType::U32},
+                                        {"side", ColumnType::U8},
+                                        {"status", ColumnType::U8}};
+
+constexpr ColumnSpec STRATEGY_SIGNAL_COLUMNS[] = {{"timestamp_us", ColumnType::U64},
+                                                  {"strategy_id", ColumnType::U32},
+                                                  {"symbol_id", ColumnType::U32},
+                                                  {"signal_type", ColumnType::U8},
+                                                  {"confidence", ColumnType::U8},
+                                                  {"target_price", ColumnType::F64},
+                                                  {"target_quantity", ColumnType::U32}};
+
+size_t type_size(ColumnType type) {
+    switch (type) {
+        case ColumnType::U8:
+            return 1;
+        case ColumnType::U32:
+            return 4;
+        case ColumnType::U64:
+        case ColumnType::I64:
+        case ColumnType::F64:
+            return 8;
+    }
+    return 0;
+}
+
+uint64_t align_up(uint64_t value) {
+    return (value + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+}
+
+// 根据行数确定各列位置，返回列描述与文件总大小
+std::pair<std::vector<ColumnDescriptor>, uint64_t> layout(std::span<const ColumnSpec> specs,
+                                                         uint64_t rows,
+                                                         bool delta_timestamps) {
+    std::vector<ColumnDescriptor> descs;
+    uint64_t offset =
+        align_up(sizeof(ColumnarFileHeader) + specs.size() * sizeof(ColumnDescriptor));
+    for (const auto& spec : specs) {
+        ColumnDescriptor desc{};
+        std::strncpy(desc.name, spec.name, sizeof(desc.name) - 1);
+        desc.type = spec.type;
+        desc.encoding = ColumnEncoding::PLAIN;
+        if (delta_timestamps && std::string_view(spec.name) == "timestamp_us") {
+            desc.type = ColumnType::I64;
+            desc.encoding = ColumnEncoding::DELTA;
+        }
+        desc.offset = offset;
+        desc.size = rows * type_size(desc.type);
+        offset = align_up(offset + desc.size);
+        descs.push_back(desc);
+    }
+    return {std::move(descs), offset};
+}
+
+// 单个列式文件的写入端：构造时按行数分配并映射整个文件，各列按行号直接写入
+class ColumnarFileWriter {
+public:
+    ColumnarFileWriter(const std::string& path,
+                       uint32_t event_type,
+                       std::span<const ColumnSpec> specs,
+                       uint64_t rows,
+                       bool delta_timestamps)
+        : ColumnarFileWriter(path, event_type, rows, layout(specs, rows, delta_timestamps)) {}
+
+    void put_timestamp(uint64_t row, uint64_t timestamp_us) {
+        if (delta_) {
+            // previous_timestamp_ 初值为 0，首行即为原值
+            put<int64_t>(0, row, static_cast<int64_t>(timestamp_us - previous_timestamp_));
+            previous_timestamp_ = timestamp_us;
+        } else {
+            put<uint64_t>(0, row, timestamp_us);
+        }
+    }
+
+    template <typename T>
+    void put(size_t column, uint64_t row, T value) {
+        std::memcpy(columns_[column] + row * sizeof(T), &value, sizeof(T));
+    }
+
+    // 实际写入行数可能少于预估（数据部分长度不足的记录被跳过），以实际行数为准
+    void finish(uint64_t rows) {
+        uint64_t row_count = rows;
+        std::memcpy(file_.mutable_data() + offsetof(ColumnarFileHeader, row_count),
+                    &row_count,
+                    sizeof(row_count));
+    }
+
+private:
+    ColumnarFileWriter(const std::string& path,
+                       uint32_t event_type,
+                       uint64_t rows,
+                       std::pair<std::vector<ColumnDescriptor>, uint64_t> layout)
+        : file_(MappedFile::create(path, layout.second)) {
+        const auto& descs = layout.first;
+        ColumnarFileHeader header{.magic = {},
+                                  .event_type = event_type,
+                                  .column_count = static_cast<uint32_t>(descs.size()),
+                                  .row_count = rows};
+        std::memcpy(header.magic, COLUMNAR_FILE_MAGIC, sizeof(header.magic));
+
+        char* data = file_.mutable_data();
+        std::memcpy(data, &header, sizeof(header));
+        std::memcpy(data + sizeof(header), descs.data(), descs.size() * sizeof(ColumnDescriptor));
+        for (const auto& desc : descs) {
+            columns_.push_back(data + desc.offset);
+        }
+        delta_ = !descs.empty() && descs.front().encoding == ColumnEncoding::DELTA;
+    }
+
+    MappedFile file_;
+    std::vector<char*> columns_;
+    bool delta_ = false;
+    uint64_t previous_timestamp_ = 0;
+};
+
+}  // namespace
+
+std::vector<std::string> ColumnarExporter::export_all(BinaryLogReader& reader,
+                                                      const std::string& directory) const {
+    std::filesystem::create_directories(directory);
+    auto dir = std::filesystem::path(directory);
+    auto stats = reader.get_statistics();
+
+    std::vector<std::string> paths = {(dir / "market_data.col").string(),
+                                      (dir / "orders.col").string(),
+                                      (dir / "strategy_signals.col").string()};
+    ColumnarFileWriter market(paths[0],
+                              MarketDataRecord::TYPE_ID,
+                              MARKET_DATA_COLUMNS,
+                              stats.market_data_records,
+                              config_.delta_timestamps);
+    ColumnarFileWriter orders(paths[1],
+                              OrderRecord::TYPE_ID,
+                              ORDER_COLUMNS,
+                              stats.order_records,
+                              config_.delta_timestamps);
+    ColumnarFileWriter signals(paths[2],
+                               StrategySignalRecord::TYPE_ID,
+                               STRATEGY_SIGNAL_COLUMNS,
+                               stats.strategy_signal_records,
+                               config_.delta_timestamps);
+
+    uint64_t market_rows = 0;
+    uint64_t order_rows = 0;
+    uint64_t signal_rows = 0;
+
+    for (const auto& record : reader.records()) {
+        switch (record.event_type()) {
+            case MarketDataRecord::TYPE_ID:
+            case FixedMarketDataRecord::TYPE_ID:
+                if (auto r = record.market_data();
+                    r && market_rows < stats.market_data_records) {
+                    auto row = market_rows++;
+                    market.put_timestamp(row, record.unix_us);
+                    market.put<uint32_t>(1, row, r->symbol_id);
+                    market.put<double>(2, row, r->price);
+                    market.put<uint64_t>(3, row, r->volume);
+                    market.put<uint8_t>(4, row, r->side);
+                }
+                break;
+            case OrderRecord::TYPE_ID:
+                if (auto r = record.as<OrderRecord>(); r && order_rows < stats.order_records) {
+                    auto row = order_rows++;
+                    orders.put_timestamp(row, record.unix_us);
+                    orders.put<uint64_t>(1, row, r->order_id);
+                    orders.put<uint32_t>(2, row, r->symbol_id);
+                    orders.put<double>(3, row, r->price);
+                    orders.put<uint32_t>(4, row, r->quantity);
+                    orders.put<uint8_t>(5, row, r->side);
+                    orders.put<uint8_t>(6, row, r->status);
+                }
+                break;
+            case StrategySignalRecord::TYPE_ID:
+                if (auto r = record.as<StrategySignalRecord>();
+                    r && signal_rows < stats.strategy_signal_records) {
+                    auto row = signal_rows++;
+                    signals.put_timestamp(row, record.unix_us);
+                    signals.put<uint32_t>(1, row, r->strategy_id);
+                    signals.put<uint32_t>(2, row, r->symbol_id);
+                    signals.put<uint8_t>(3, row, r->signal_type);
+                    signals.put<uint8_t>(4, row, r->confidence);
+                    signals.put<double>(5, row, r->target_price);
+                    signals.put<uint32_t>(6, row, r->target_quantity);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    market.finish(market_rows);
+    orders.finish(order_rows);
+    signals.finish(signal_rows);
+    return paths;
+}
+
+// ColumnarFile 实现
+ColumnarFile::ColumnarFile(const std::string& path) : file_(path) {
+    if (file_.size() < sizeof(ColumnarFileHeader) ||
+        std::memcmp(header().magic, COLUMNAR_FILE_MAGIC, sizeof(COLUMNAR_FILE_MAGIC)) != 0 ||
+        file_.size() - sizeof(ColumnarFileHeader) <
+            uint64_t{header().column_count} * sizeof(ColumnDescriptor)) {
+        throw std::runtime_error("Not a columnar file: " + path);
+    }
+    for (const auto& desc : columns()) {
+        if (desc.offset % COLUMN_ALIGNMENT != 0 || desc.offset > file_.size() ||
+            desc.size > file_.size() - desc.offset ||
+            desc.size < row_count() * type_size(desc.type)) {
+            throw std::runtime_error("Corrupted columnar file: " + path);
+        }
+    }
+}
+
+std::span<const ColumnDescriptor> ColumnarFile::columns() const {
+    return {reinterpret_cast<const ColumnDescriptor*>(file_.data() + sizeof(ColumnarFileHeader)),
+            header().column_count};
+}
+
+const ColumnDescriptor* ColumnarFile::find_column(std::string_view name) const {
+    for (const auto& desc : columns()) {
+        if (name == std::string_view(desc.name, strnlen(desc.name, sizeof(desc.name)))) {
+            return &desc;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<uint64_t> ColumnarFile::timestamps() const {
+    const auto* desc = find_column("timestamp_us");
+    if (desc == nullptr) {
+        return {};
+    }
+    if (desc->encoding == ColumnEncoding::PLAIN) {
+        auto values = column<uint64_t>("timestamp_us");
+        return {values.begin(), values.end()};
+    }
+
+    auto deltas = column<int64_t>("timestamp_us");
+    std::vector<uint64_t> result;
+    result.reserve(deltas.size());
+    uint64_t current = 0;
+    for (auto delta : deltas) {
+        current += static_cast<uint64_t>(delta);
+        result.push_back(current);
+    }
+    return result;
+}
+
+}  // namespace cppshares::utils
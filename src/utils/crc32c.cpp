@@ -0,0 +1,87 @@
+#include "cppshares/utils/crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace cppshares::utils {
+
+namespace {
+
+using Crc32cImpl = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+
+constexpr std::array<uint32_t, 256> make_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr auto CRC32C_TABLE = make_table();
+
+uint32_t crc32c_software(const uint8_t* data, size_t size, uint32_t crc) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = CRC32C_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t crc32c_sse42(const uint8_t* data,
+                                                        size_t size,
+                                                        uint32_t crc) {
+    uint64_t crc64 = crc;
+    for (; size >= 8; size -= 8, data += 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    auto crc32 = static_cast<uint32_t>(crc64);
+    for (; size > 0; --size, ++data) {
+        crc32 = _mm_crc32_u8(crc32, *data);
+    }
+    return crc32;
+}
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+uint32_t crc32c_armv8(const uint8_t* data, size_t size, uint32_t crc) {
+    for (; size >= 8; size -= 8, data += 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    for (; size > 0; --size, ++data) {
+        crc = __crc32cb(crc, *data);
+    }
+    return crc;
+}
+#endif
+
+Crc32cImpl select_impl() {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2")) {
+        return crc32c_sse42;
+    }
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    return crc32c_armv8;
+#endif
+    return crc32c_software;
+}
+
+}  // namespace
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc) {
+    static const Crc32cImpl impl = select_impl();
+    return ~impl(static_cast<const uint8_t*>(data), size, ~crc);
+}
+
+}  // namespace cppshares::utils
@@ -1,46 +1,257 @@
 #include "cppshares/utils/logger.hpp"
 
-#include <chrono>
-#include <filesystem>
-#include <fstream>
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <bit>
 
 namespace cppshares::utils {
 
-void Logger::log_json_response(const std::string& provider_name,
-                               const std::string& operation_type,
-                               const std::string& symbol,
-                               const std::string& json_response) {
-    try {
-        // 创建logs目录（如果不存在）
-        std::filesystem::create_directories("logs/json_responses");
-
-        // 生成文件名：logs/json_responses/{provider}_{operation}_{symbol}_{timestamp}.json
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        auto ms =
-            std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-
-        std::ostringstream filename;
-        filename << "logs/json_responses/" << provider_name << "_" << operation_type << "_"
-                 << symbol << "_" << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S") << "_"
-                 << std::setfill('0') << std::setw(3) << ms.count() << ".json";
-
-        // 写入JSON响应到文件
-        std::ofstream file(filename.str());
-        if (file.is_open()) {
-            file << json_response;
-            file.close();
-
-            // 记录到文本日志
-            Logger::debug("JSON response saved: {}", filename.str());
-        } else {
-            Logger::error("Failed to create JSON response file: {}", filename.str());
+namespace {
+
+std::mutex capture_mutex;
+std::shared_ptr<ResponseCapture> capture_instance;
+
+std::shared_ptr<ResponseCapture> current_capture() {
+    std::lock_guard<std::mutex> lock(capture_mutex);
+    if (!capture_instance) {
+        capture_instance = std::make_shared<ResponseCapture>();
+    }
+    return capture_instance;
+}
+
+}  // namespace
+
+// BinaryLogger 实现
+BinaryLogger::BinaryLogger(const std::string& filename,
+                           TimestampSource timestamp_source,
+                           SegmentConfig segments)
+    : write_buffer_(BUFFER_SIZE), timestamp_source_(timestamp_source) {
+    if (timestamp_source_ == TimestampSource::TSC) {
+        calibrator_ = std::make_unique<TscCalibrator>();
+    }
+    if (segments.enabled()) {
+        segments_ = std::make_unique<BinaryLogSegments>(filename, segments);
+        open_segment();
+        return;
+    }
+
+    open_file(filename);
+    // 每次打开都写入校准记录，追加到已有文件时读取端据此切换时间戳解释方式
+    write_calibration();
+}
+
+BinaryLogger::BinaryLogger(const std::string& filename,
+                           AsyncLogConfig config,
+                           TimestampSource timestamp_source,
+                           SegmentConfig segments)
+    : BinaryLogger(filename, timestamp_source, segments) {
+    async_ = true;
+    async_config_ = config;
+
+    size_t capacity = std::bit_ceil(std::max<size_t>(config.ring_capacity, 2));
+    ring_ = std::make_unique<Slot[]>(capacity);
+    ring_mask_ = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        ring_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    flusher_ = std::thread([this] { run_flusher(); });
+}
+
+BinaryLogger::~BinaryLogger() {
+    if (async_) {
+        stopping_.store(true, std::memory_order_release);
+        if (flusher_.joinable()) {
+            flusher_.join();
+        }
+    }
+    flush_buffer();
+    if (segments_) {
+        binary_file_.close();
+        segments_->close_current(segment_bytes_);
+    }
+}
+
+void BinaryLogger::open_file(const std::string& path) {
+    std::error_code ec;
+    bool fresh = !std::filesystem::exists(path, ec) || std::filesystem::file_size(path, ec) == 0;
+    binary_file_.open(path, std::ios::binary | std::ios::app);
+    segment_bytes_ = 0;
+    if (!fresh) {
+        return;
+    }
+
+    // 文件头不属于任何块，直接写入文件
+    BinaryLogEntry header{.timestamp_us = 0,
+                          .event_type = LogFileHeaderRecord::TYPE_ID,
+                          .data_size = sizeof(LogFileHeaderRecord)};
+    LogFileHeaderRecord record{};
+    std::memcpy(record.magic, BINARY_LOG_FILE_MAGIC, sizeof(record.magic));
+    record.version = BINARY_LOG_FORMAT_VERSION;
+    binary_file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    binary_file_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    segment_bytes_ = sizeof(header) + sizeof(record);
+}
+
+void BinaryLogger::open_segment() {
+    open_file(segments_->open_next());
+    // 每个分段以校准记录开头，可以单独读取
+    write_calibration();
+
+    auto age = segments_->config().max_segment_age;
+    if (age.count() <= 0) {
+        segment_deadline_ = UINT64_MAX;
+    } else if (calibrator_ && calibrator_->current().ns_per_tick > 0) {
+        auto age_ns = std::chrono::duration<double, std::nano>(age).count();
+        segment_deadline_ = read_cycle_counter() +
+                            static_cast<uint64_t>(age_ns / calibrator_->current().ns_per_tick);
+    } else {
+        auto age_us = std::chrono::duration_cast<std::chrono::microseconds>(age).count();
+        segment_deadline_ = current_timestamp() + static_cast<uint64_t>(age_us);
+    }
+}
+
+void BinaryLogger::rotate_segment() {
+    flush_buffer();
+    binary_file_.close();
+    segments_->close_current(segment_bytes_);
+    open_segment();
+}
+
+void BinaryLogger::write_calibration() {
+    ClockCalibrationRecord record{.reference_ticks = 0, .reference_unix_ns = 0, .ns_per_tick = 0.0};
+    if (calibrator_) {
+        const auto& calibration = calibrator_->recalibrate();
+        record.reference_ticks = calibration.reference_ticks;
+        record.reference_unix_ns = calibration.reference_unix_ns;
+        record.ns_per_tick = calibration.ns_per_tick;
+
+        if (recalibration_ticks_ == 0 && calibration.ns_per_tick > 0) {
+            recalibration_ticks_ = static_cast<uint64_t>(
+                std::chrono::duration<double, std::nano>(RECALIBRATION_INTERVAL).count() /
+                calibration.ns_per_tick);
         }
+        next_calibration_ticks_ = calibration.reference_ticks + recalibration_ticks_;
+    }
+
+    BinaryLogEntry header{
+        .timestamp_us = record.reference_ticks,
+        .event_type = ClockCalibrationRecord::TYPE_ID,
+        .data_size = sizeof(ClockCalibrationRecord)};
+    write_record_to_buffer(header, &record, sizeof(record));
+}
+
+void BinaryLogger::flush() {
+    if (!async_) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        flush_buffer();
+        return;
+    }
+
+    uint64_t target = enqueue_pos_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    flush_requested_.store(true, std::memory_order_release);
+    flushed_.wait(lock, [&] { return flushed_pos_ >= target; });
+    flush_requested_.store(false, std::memory_order_release);
+}
+
+void BinaryLogger::write_locked(const BinaryLogEntry& header,
+                                const void* record,
+                                size_t record_size) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (async_) {
+        // 先写出已入队的记录，保持与本线程之前写入的记录的先后顺序
+        drain();
+    }
+
+    if (calibrator_ && header.timestamp_us >= next_calibration_ticks_) {
+        write_calibration();
+    }
+    write_record_to_buffer(header, record, record_size);
+
+    // 异步模式下立即落盘：这条记录不经过队列，flush() 无法等待它
+    if (segments_ && segment_due(header.timestamp_us)) {
+        rotate_segment();
+    } else if (async_ || buffer_pos_ > BUFFER_SIZE - 1024) {
+        flush_buffer();
+    }
+}
+
+size_t BinaryLogger::drain() {
+    size_t drained = 0;
+    while (true) {
+        Slot& slot = ring_[dequeue_pos_ & ring_mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+            break;
+        }
+
+        write_to_buffer(slot.payload, slot.size);
+        slot.sequence.store(dequeue_pos_ + ring_mask_ + 1, std::memory_order_release);
+        dequeue_pos_++;
+        drained++;
+    }
+    return drained;
+}
+
+void BinaryLogger::run_flusher() {
+    while (true) {
+        // 先读停止标志再排空，保证停止前入队的记录都被写出
+        bool stopping = stopping_.load(std::memory_order_acquire);
+        size_t drained = 0;
+        std::optional<uint64_t> flushed_pos;
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            if (calibrator_ && read_cycle_counter() >= next_calibration_ticks_) {
+                write_calibration();
+            }
+            drained = drain();
+            if (segments_ && segment_due(current_timestamp())) {
+                rotate_segment();
+            }
+
+            // 队列暂时为空或有线程在等待 flush() 时才落盘，持续写入时按 64KB 批量写出
+            if (drained == 0 || flush_requested_.load(std::memory_order_acquire)) {
+                flush_buffer();
+                flushed_pos = dequeue_pos_;
+            }
+        }
+
+        if (flushed_pos) {
+            {
+                std::lock_guard<std::mutex> lock(flush_mutex_);
+                flushed_pos_ = *flushed_pos;
+            }
+            flushed_.notify_all();
+        }
+
+        if (drained == 0) {
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(async_config_.idle_sleep);
+        }
+    }
+}
+
+void Logger::capture_response(std::string_view provider_name,
+                              std::string_view operation_type,
+                              std::string_view symbol,
+                              std::string_view response,
+                              bool error) {
+    try {
+        current_capture()->capture(provider_name, operation_type, symbol, response, error);
     } catch (const std::exception& e) {
-        Logger::error("Error saving JSON response: {}", e.what());
+        Logger::error("Error capturing response: {}", e.what());
+    }
+}
+
+void Logger::configure_capture(const CaptureConfig& config) {
+    auto capture = std::make_shared<ResponseCapture>(config);
+    std::shared_ptr<ResponseCapture> previous;
+    {
+        std::lock_guard<std::mutex> lock(capture_mutex);
+        previous = std::exchange(capture_instance, std::move(capture));
     }
+    // previous 析构时写完剩余记录并停止后台线程
 }
 
-}  // namespace cppshares::utils
\ No newline at end of file
+}  // namespace cppshares::utils
@@ -0,0 +1,47 @@
+#include "cppshares/utils/price.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+namespace cppshares::utils {
+
+std::string Price::to_string(int decimals) const {
+    std::string out;
+    append_to(out, decimals);
+    return out;
+}
+
+void Price::append_to(std::string& out, int decimals) const {
+    decimals = std::clamp(decimals, 0, 9);
+    int kept = std::min(decimals, DECIMALS);
+
+    int64_t divisor = 1;
+    for (int i = kept; i < DECIMALS; ++i) {
+        divisor *= 10;
+    }
+    auto rounded = round_to(from_raw(divisor)).raw_;
+    if (rounded < 0) {
+        out.push_back('-');
+    }
+    // 取绝对值时避开 INT64_MIN 的溢出
+    auto magnitude =
+        rounded < 0 ? uint64_t{0} - static_cast<uint64_t>(rounded) : static_cast<uint64_t>(rounded);
+
+    char buffer[24];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), magnitude / SCALE).ptr;
+    out.append(buffer, end);
+    if (decimals == 0) {
+        return;
+    }
+
+    out.push_back('.');
+    auto fraction = magnitude % SCALE / static_cast<uint64_t>(divisor);
+    for (int i = kept - 1; i >= 0; --i) {
+        buffer[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    out.append(buffer, static_cast<size_t>(kept));
+    out.append(static_cast<size_t>(decimals - kept), '0');
+}
+
+}  // namespace cppshares::utils
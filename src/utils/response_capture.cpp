@@ -0,0 +1,253 @@
+#include "cppshares/utils/response_capture.hpp"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace cppshares::utils {
+
+namespace {
+
+bool sampled(double rate) {
+    if (rate >= 1.0) {
+        return true;
+    }
+    if (rate <= 0.0) {
+        return false;
+    }
+    thread_local std::minstd_rand rng{std::random_device{}()};
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < rate;
+}
+
+uint64_t to_microseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+}  // namespace
+
+// ResponseCapture 实现
+ResponseCapture::ResponseCapture(CaptureConfig config) : config_(std::move(config)) {
+    if (!config_.enabled) {
+        return;
+    }
+
+    auto parent = std::filesystem::path(config_.path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent);
+    }
+
+    bool is_new = !std::filesystem::exists(config_.path) ||
+                  std::filesystem::file_size(config_.path) == 0;
+    file_.open(config_.path, std::ios::binary | std::ios::app);
+    if (!file_.is_open()) {
+        throw std::runtime_error("Failed to open capture file: " + config_.path);
+    }
+    if (is_new) {
+        file_.write(CAPTURE_FILE_MAGIC, sizeof(CAPTURE_FILE_MAGIC));
+    }
+
+    writer_ = std::thread([this] { run(); });
+}
+
+ResponseCapture::~ResponseCapture() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void ResponseCapture::capture(std::string_view provider,
+                              std::string_view operation,
+                              std::string_view symbol,
+                              std::string_view body,
+                              bool error) {
+    if (!config_.enabled) {
+        return;
+    }
+    if (!sampled(error ? config_.error_sample_rate : config_.sample_rate)) {
+        sampled_out_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    CapturedResponse record{.timestamp = std::chrono::system_clock::now(),
+                            .provider = std::string(provider),
+                            .operation = std::string(operation),
+                            .symbol = std::string(symbol),
+                            .body = std::string(body),
+                            .error = error};
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queued_bytes_ + body.size() > config_.max_queue_bytes) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        queued_bytes_ += body.size();
+        queue_.push_back(std::move(record));
+    }
+    wake_.notify_one();
+}
+
+void ResponseCapture::flush() {
+    if (!config_.enabled) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this] { return queue_.empty() && !writing_; });
+}
+
+ResponseCapture::Statistics ResponseCapture::get_statistics() const {
+    Statistics stats;
+    stats.captured = captured_.load(std::memory_order_relaxed);
+    stats.sampled_out = sampled_out_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ResponseCapture::run() {
+    std::deque<CapturedResponse> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty() && stopping_) {
+                break;
+            }
+            batch.swap(queue_);
+            queued_bytes_ = 0;
+            writing_ = true;
+        }
+
+        for (const auto& record : batch) {
+            write_record(record);
+        }
+        batch.clear();
+        file_.flush();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            writing_ = false;
+        }
+        drained_.notify_all();
+    }
+    file_.flush();
+}
+
+void ResponseCapture::write_record(const CapturedResponse& record) {
+    const std::string* payload = &record.body;
+    std::string compressed;
+    uint8_t flags = record.error ? CaptureRecordHeader::FLAG_ERROR : 0;
+
+    if (config_.compress && record.body.size() >= config_.compress_threshold) {
+        uLongf compressed_size = compressBound(record.body.size());
+        compressed.resize(compressed_size);
+        // 采集以吞吐为先，使用最快的压缩级别
+        if (compress2(reinterpret_cast<Bytef*>(compressed.data()),
+                      &compressed_size,
+                      reinterpret_cast<const Bytef*>(record.body.data()),
+                      record.body.size(),
+                      Z_BEST_SPEED) == Z_OK &&
+            compressed_size < record.body.size()) {
+            compressed.resize(compressed_size);
+            payload = &compressed;
+            flags |= CaptureRecordHeader::FLAG_COMPRESSED;
+        }
+    }
+
+    CaptureRecordHeader header{
+        .record_size = 0,
+        .timestamp_us = to_microseconds(record.timestamp),
+        .raw_size = static_cast<uint32_t>(record.body.size()),
+        .stored_size = static_cast<uint32_t>(payload->size()),
+        .provider_size = static_cast<uint16_t>(record.provider.size()),
+        .operation_size = static_cast<uint16_t>(record.operation.size()),
+        .symbol_size = static_cast<uint16_t>(record.symbol.size()),
+        .flags = flags,
+        .reserved = 0};
+    header.record_size = static_cast<uint32_t>(sizeof(header) - sizeof(header.record_size) +
+                                               header.provider_size + header.operation_size +
+                                               header.symbol_size + header.stored_size);
+
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.write(record.provider.data(), header.provider_size);
+    file_.write(record.operation.data(), header.operation_size);
+    file_.write(record.symbol.data(), header.symbol_size);
+    file_.write(payload->data(), payload->size());
+
+    captured_.fetch_add(1, std::memory_order_relaxed);
+    bytes_written_.fetch_add(sizeof(header.record_size) + header.record_size,
+                             std::memory_order_relaxed);
+}
+
+// ResponseCaptureReader 实现
+ResponseCaptureReader::ResponseCaptureReader(const std::string& path)
+    : file_(path, std::ios::binary) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("Failed to open capture file: " + path);
+    }
+
+    char magic[sizeof(CAPTURE_FILE_MAGIC)];
+    if (!file_.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, CAPTURE_FILE_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a response capture file: " + path);
+    }
+}
+
+std::optional<CapturedResponse> ResponseCaptureReader::next() {
+    CaptureRecordHeader header;
+    if (!file_.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return std::nullopt;
+    }
+
+    CapturedResponse record;
+    record.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::microseconds(header.timestamp_us)));
+    record.error = (header.flags & CaptureRecordHeader::FLAG_ERROR) != 0;
+    record.provider.resize(header.provider_size);
+    record.operation.resize(header.operation_size);
+    record.symbol.resize(header.symbol_size);
+
+    std::string stored(header.stored_size, '\0');
+    if (!file_.read(record.provider.data(), header.provider_size) ||
+        !file_.read(record.operation.data(), header.operation_size) ||
+        !file_.read(record.symbol.data(), header.symbol_size) ||
+        !file_.read(stored.data(), header.stored_size)) {
+        return std::nullopt;  // 写入中断留下的不完整尾部记录
+    }
+
+    if (header.flags & CaptureRecordHeader::FLAG_COMPRESSED) {
+        record.body.resize(header.raw_size);
+        uLongf raw_size = header.raw_size;
+        if (uncompress(reinterpret_cast<Bytef*>(record.body.data()),
+                       &raw_size,
+                       reinterpret_cast<const Bytef*>(stored.data()),
+                       stored.size()) != Z_OK ||
+            raw_size != header.raw_size) {
+            return std::nullopt;
+        }
+    } else {
+        record.body = std::move(stored);
+    }
+    return record;
+}
+
+size_t ResponseCaptureReader::replay(const std::function<void(const CapturedResponse&)>& handler) {
+    size_t count = 0;
+    while (auto record = next()) {
+        handler(*record);
+        count++;
+    }
+    return count;
+}
+
+}  // namespace cppshares::utils
@@ -0,0 +1,130 @@
+#include "cppshares/utils/symbol_registry.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+
+namespace cppshares::utils {
+
+SymbolRegistry::~SymbolRegistry() {
+    for (auto& chunk : chunks_) {
+        delete chunk.load(std::memory_order_relaxed);
+    }
+}
+
+SymbolRegistry& SymbolRegistry::global() {
+    static SymbolRegistry registry;
+    return registry;
+}
+
+SymbolId SymbolRegistry::intern(std::string_view name) {
+    if (auto id = find(name)) {
+        return *id;
+    }
+
+    std::unique_lock lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    auto id = static_cast<SymbolId>(size_.load(std::memory_order_relaxed));
+    const auto& stored = names_.emplace_back(name);
+    publish(id, &stored);
+    ids_.emplace(stored, id);
+    return id;
+}
+
+std::optional<SymbolId> SymbolRegistry::find(std::string_view name) const {
+    std::shared_lock lock(mutex_);
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void SymbolRegistry::assign(SymbolId id, std::string_view name) {
+    std::unique_lock lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        if (it->second != id) {
+            throw std::runtime_error("Symbol " + std::string(name) + " already has id " +
+                                     std::to_string(it->second));
+        }
+        return;
+    }
+    if (id < size_.load(std::memory_order_relaxed) && !this->name(id).empty()) {
+        throw std::runtime_error("Symbol id " + std::to_string(id) + " already assigned to " +
+                                 this->name(id));
+    }
+
+    const auto& stored = names_.emplace_back(name);
+    publish(id, &stored);
+    ids_.emplace(stored, id);
+}
+
+const std::string& SymbolRegistry::name(SymbolId id) const {
+    static const std::string empty;
+    if (id >= size_.load(std::memory_order_acquire)) {
+        return empty;
+    }
+    const Chunk* chunk = chunks_[id / CHUNK_SIZE].load(std::memory_order_acquire);
+    const std::string* name = (*chunk)[id % CHUNK_SIZE].load(std::memory_order_acquire);
+    return name != nullptr ? *name : empty;
+}
+
+void SymbolRegistry::publish(SymbolId id, const std::string* name) {
+    size_t new_size = std::max<size_t>(size_.load(std::memory_order_relaxed), size_t{id} + 1);
+    if ((new_size - 1) / CHUNK_SIZE >= MAX_CHUNKS) {
+        throw std::runtime_error("Symbol registry is full");
+    }
+    // id 可能跳过若干未注册的位置，分块需覆盖到新的上界
+    for (size_t i = 0; i <= (new_size - 1) / CHUNK_SIZE; ++i) {
+        if (chunks_[i].load(std::memory_order_relaxed) == nullptr) {
+            chunks_[i].store(new Chunk{}, std::memory_order_release);
+        }
+    }
+    Chunk* chunk = chunks_[id / CHUNK_SIZE].load(std::memory_order_relaxed);
+    (*chunk)[id % CHUNK_SIZE].store(name, std::memory_order_release);
+    size_.store(new_size, std::memory_order_release);
+}
+
+void SymbolRegistry::load(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string_view view(line);
+        auto pos = view.find(',');
+        SymbolId id = 0;
+        if (pos != std::string_view::npos &&
+            std::from_chars(view.data(), view.data() + pos, id).ec == std::errc{}) {
+            assign(id, view.substr(pos + 1));
+        }
+    }
+}
+
+bool SymbolRegistry::save(const std::string& path) const {
+    auto temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        std::shared_lock lock(mutex_);
+        for (size_t id = 0; id < size_.load(std::memory_order_relaxed); ++id) {
+            const auto& symbol = name(static_cast<SymbolId>(id));
+            if (!symbol.empty()) {
+                file << id << ',' << symbol << '\n';
+            }
+        }
+        if (!file) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    return !ec;
+}
+
+}  // namespace cppshares::utils
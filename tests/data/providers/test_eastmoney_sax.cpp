@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "cppshares/data/providers/eastmoney_sax.hpp"
+
+using namespace cppshares::data;
+using namespace cppshares::data::providers;
+
+TEST(EastMoneySaxTest, DecodeQuote) {
+    MarketTick tick{};
+    auto status = EastMoneySax::decode_quote(
+        R"({"rc":0,"data":{"f2":10.52,"f3":1.25,"f5":123456,"f15":10.8}})", tick);
+    ASSERT_EQ(status, SaxDecodeStatus::OK);
+    EXPECT_DOUBLE_EQ(tick.price, 10.52);
+    EXPECT_EQ(tick.volume, 123456);
+
+    // 停牌时价格为 "-"、data 为 null 都视为没有数据
+    EXPECT_EQ(EastMoneySax::decode_quote(R"({"data":{"f2":"-","f5":0}})", tick),
+              SaxDecodeStatus::NO_DATA);
+    EXPECT_EQ(EastMoneySax::decode_quote(R"({"rc":100,"data":null})", tick),
+              SaxDecodeStatus::NO_DATA);
+
+    // 非预期结构交给 DOM 回退路径
+    EXPECT_EQ(EastMoneySax::decode_quote(R"({"data":[1,2]})", tick),
+              SaxDecodeStatus::UNEXPECTED);
+    EXPECT_EQ(EastMoneySax::decode_quote(R"({"data":{"f2":1)", tick),
+              SaxDecodeStatus::UNEXPECTED);
+}
+
+TEST(EastMoneySaxTest, DecodeKlines) {
+    std::vector<OHLCV> klines;
+    size_t invalid_rows = 0;
+    auto status = EastMoneySax::decode_klines(
+        R"({"rc":0,"data":{"code":"000001","name":"x","klines":[)"
+        R"("2024-01-02,9.39,9.21,9.42,9.21,1158366,1075742252.45,2.24,-1.92,-0.18,0.60",)"
+        R"("bad row",)"
+        R"("2024-01-03,9.19,9.20,9.22,9.02,733610,669557219.26,2.17,-0.11,-0.01,0.38"]}})",
+        klines,
+        invalid_rows);
+
+    ASSERT_EQ(status, SaxDecodeStatus::OK);
+    ASSERT_EQ(klines.size(), 2);
+    EXPECT_EQ(invalid_rows, 1);
+    EXPECT_DOUBLE_EQ(klines[0].open, 9.39);
+    EXPECT_DOUBLE_EQ(klines[1].close, 9.20);
+    EXPECT_EQ(klines[1].volume, 733610);
+    EXPECT_LT(klines[0].timestamp, klines[1].timestamp);
+
+    klines.clear();
+    EXPECT_EQ(EastMoneySax::decode_klines(R"({"data":null})", klines, invalid_rows),
+              SaxDecodeStatus::NO_DATA);
+    EXPECT_EQ(EastMoneySax::decode_klines(R"({"data":{"klines":"oops"}})", klines, invalid_rows),
+              SaxDecodeStatus::UNEXPECTED);
+    EXPECT_TRUE(klines.empty());
+}
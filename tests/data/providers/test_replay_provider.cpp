@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+#include "cppshares/data/providers/replay_provider.hpp"
+#include "cppshares/utils/logger.hpp"
+
+using namespace cppshares::data;
+using namespace cppshares::data::providers;
+using cppshares::utils::BinaryLogger;
+using cppshares::utils::MarketDataRecord;
+
+class ReplayProviderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("cppshares_replay_" + std::to_string(::getpid()) + ".bin"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override { std::filesystem::remove(path_); }
+
+    static MarketDataRecord make_record(SymbolId symbol_id, double price) {
+        return {.symbol_id = symbol_id,
+                .price = price,
+                .volume = 100,
+                .side = 0,
+                .padding = {0, 0, 0}};
+    }
+
+    std::string path_;
+};
+
+TEST_F(ReplayProviderTest, FeedsCallbackAndAggregator) {
+    Symbol pingan("000001", Market::SZ);
+    Symbol vanke("000002", Market::SZ);
+    {
+        BinaryLogger logger(path_);
+        for (int i = 0; i < 1000; ++i) {
+            logger.log_binary(make_record(i % 2 == 0 ? pingan.id() : vanke.id(), 10.0 + i));
+        }
+    }
+
+    auto provider = std::make_shared<ReplayProvider>(path_, ReplayConfig{.speed = 0.0});
+
+    size_t ticks = 0;
+    double last_price = 0.0;
+    SymbolId last_symbol = INVALID_SYMBOL_ID;
+    auto replayed = provider->replay([&](const MarketTick& tick) {
+        ticks++;
+        last_price = tick.price;
+        last_symbol = tick.symbol_id;
+        return true;
+    });
+    EXPECT_EQ(replayed, 1000u);
+    EXPECT_EQ(ticks, 1000u);
+    EXPECT_DOUBLE_EQ(last_price, 1009.0);
+    EXPECT_EQ(last_symbol, vanke.id());
+
+    DataAggregator aggregator;
+    aggregator.register_provider(provider);
+    aggregator.set_strategy(std::make_unique<FailoverStrategy>());
+    aggregator.set_cache_config({.enabled = false});
+    auto quote = aggregator.get_realtime_quote(pingan);
+    ASSERT_TRUE(quote.has_value());
+    EXPECT_EQ(quote->symbol_id, pingan.id());
+    EXPECT_EQ(quote->symbol_name(), pingan.to_string());
+    EXPECT_DOUBLE_EQ(quote->price, 1008.0);
+
+    // 回调返回 false 时停止
+    EXPECT_EQ(provider->replay([](const MarketTick&) { return false; }), 1u);
+}
+
+TEST_F(ReplayProviderTest, SkipsUnknownSymbolIds) {
+    Symbol pingan("000001", Market::SZ);
+    {
+        BinaryLogger logger(path_);
+        logger.log_binary(make_record(0xFFFFFFFF, 1.0));
+        logger.log_binary(make_record(pingan.id(), 10.0));
+        logger.log_binary(make_record(0xFFFFFFF0, 2.0));
+    }
+
+    ReplayProvider provider(path_, {.speed = 0.0});
+    std::vector<SymbolId> ids;
+    auto replayed = provider.replay([&](const MarketTick& tick) {
+        ids.push_back(tick.symbol_id);
+        return true;
+    });
+    EXPECT_EQ(replayed, 1u);
+    EXPECT_EQ(ids, std::vector<SymbolId>{pingan.id()});
+    ASSERT_TRUE(provider.get_realtime_quote(pingan).has_value());
+}
+
+TEST_F(ReplayProviderTest, PacesByRecordTimestamps) {
+    auto symbol_id = Symbol("600000", Market::SH).id();
+    {
+        BinaryLogger logger(path_);
+        for (int i = 0; i < 3; ++i) {
+            logger.log_binary(make_record(symbol_id, 10.0 + i));
+            if (i < 2) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+    }
+
+    auto elapsed_ms = [&](double speed) {
+        ReplayProvider provider(path_, {.speed = speed});
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(provider.replay(), 3u);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    EXPECT_GE(elapsed_ms(1.0), 195);
+    EXPECT_GE(elapsed_ms(4.0), 48);
+    // 不限速回放只校验记录数；耗时受机器负载影响，不设上限
+    elapsed_ms(0.0);
+}
+
+TEST_F(ReplayProviderTest, AsFastAsPossibleThroughput) {
+    constexpr int RECORDS = 1000000;
+    std::vector<SymbolId> ids;
+    for (int i = 0; i < 500; ++i) {
+        ids.push_back(Symbol(std::to_string(600000 + i), Market::SH).id());
+    }
+    {
+        BinaryLogger logger(path_);
+        for (int i = 0; i < RECORDS; ++i) {
+            logger.log_binary(make_record(ids[i % 500], 10.0 + i % 100));
+        }
+    }
+
+    ReplayProvider provider(path_, {.speed = 0.0});
+
+    double volume = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    auto replayed = provider.replay([&](const MarketTick& tick) {
+        volume += static_cast<double>(tick.volume);
+        return true;
+    });
+    auto seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(replayed, static_cast<size_t>(RECORDS));
+    EXPECT_DOUBLE_EQ(volume, 100.0 * RECORDS);
+    std::cout << "Replayed " << RECORDS << " records in " << seconds * 1000 << " ms ("
+              << RECORDS / seconds / 1e6 << " M records/s)" << std::endl;
+}
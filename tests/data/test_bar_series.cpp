@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "cppshares/data/bar_series.hpp"
+#include "cppshares/utils/math.hpp"
+
+namespace cppshares::data::tests {
+
+namespace {
+
+std::vector<OHLCV> make_bars(SymbolId symbol_id, int count) {
+    std::vector<OHLCV> bars;
+    for (int i = 0; i < count; ++i) {
+        bars.push_back({.symbol_id = symbol_id,
+                        .timestamp = std::chrono::system_clock::time_point(std::chrono::minutes(i)),
+                        .open = 10.0 + i,
+                        .high = 11.0 + i,
+                        .low = 9.0 + i,
+                        .close = 10.5 + i,
+                        .volume = static_cast<uint64_t>(100 * (i + 1)),
+                        .amount = 1000.0 * (i + 1)});
+    }
+    return bars;
+}
+
+}  // namespace
+
+TEST(BarSeriesTest, RoundTripsThroughBars) {
+    auto symbol_id = Symbol("600000", Market::SH).id();
+    auto bars = make_bars(symbol_id, 100);
+
+    auto series = BarSeries::from_bars(bars);
+    ASSERT_EQ(series.size(), 100u);
+    EXPECT_EQ(series.symbol_id(), symbol_id);
+    EXPECT_EQ(series.symbol_name(), "600000.SH.STOCK");
+    EXPECT_EQ(series.timestamp(3), bars[3].timestamp);
+    EXPECT_EQ(series.timestamps_us()[1], 60'000'000);
+    EXPECT_DOUBLE_EQ(series.close()[99], 109.5);
+    EXPECT_EQ(series.volume()[0], 100u);
+
+    // 各列首地址按缓存行对齐
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(series.close().data()) % BAR_COLUMN_ALIGNMENT, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(series.volume().data()) % BAR_COLUMN_ALIGNMENT, 0u);
+
+    auto restored = series.to_bars();
+    ASSERT_EQ(restored.size(), bars.size());
+    for (size_t i = 0; i < bars.size(); ++i) {
+        EXPECT_EQ(restored[i].symbol_id, bars[i].symbol_id);
+        EXPECT_EQ(restored[i].timestamp, bars[i].timestamp);
+        EXPECT_DOUBLE_EQ(restored[i].open, bars[i].open);
+        EXPECT_DOUBLE_EQ(restored[i].high, bars[i].high);
+        EXPECT_DOUBLE_EQ(restored[i].low, bars[i].low);
+        EXPECT_DOUBLE_EQ(restored[i].close, bars[i].close);
+        EXPECT_EQ(restored[i].volume, bars[i].volume);
+        EXPECT_DOUBLE_EQ(restored[i].amount, bars[i].amount);
+    }
+
+    // 不同证券的K线不能混入同一序列
+    auto other = make_bars(Symbol("000001", Market::SZ).id(), 1);
+    EXPECT_THROW(series.push_back(other[0]), std::invalid_argument);
+    bars.push_back(other[0]);
+    EXPECT_THROW(BarSeries::from_bars(bars), std::invalid_argument);
+}
+
+TEST(BarSeriesTest, IndicatorsOnColumns) {
+    auto bars = make_bars(Symbol("600000", Market::SH).id(), 30);
+    auto series = BarSeries::from_bars(bars);
+
+    std::vector<double> closes;
+    for (const auto& bar : bars) {
+        closes.push_back(bar.close);
+    }
+
+    EXPECT_DOUBLE_EQ(utils::moving_average(series.close(), 5), utils::moving_average(closes, 5));
+    EXPECT_DOUBLE_EQ(utils::moving_average(series.volume(), 2), 2950.0);
+    EXPECT_DOUBLE_EQ(utils::calculate_rsi(series.close()), utils::calculate_rsi(closes));
+    EXPECT_DOUBLE_EQ(utils::calculate_bollinger_bands(series.close(), 20).middle,
+                     utils::calculate_bollinger_bands(closes, 20).middle);
+    EXPECT_DOUBLE_EQ(utils::max_drawdown(series.low().subspan(10)), 0.0);
+}
+
+}  // namespace cppshares::data::tests
@@ -1,6 +1,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <thread>
+#include <unordered_set>
+
 #include "cppshares/data/data_strategy.hpp"
 #include "cppshares/data/data_types.hpp"
 
@@ -18,6 +21,98 @@ public:
     MOCK_METHOD(int, get_priority, (), (const, override));
     MOCK_METHOD(int, get_rate_limit, (), (const, override));
     MOCK_METHOD(bool, health_check, (), (override));
+
+    // 模拟连接失败：报告请求失败并返回空结果
+    std::optional<MarketTick> fail_request() {
+        note_request_failed();
+        return std::nullopt;
+    }
+};
+
+// 模拟慢速网络的提供者，不加锁，用于验证聚合器不会串行化请求
+class FakeSlowProvider : public DataProvider {
+public:
+    explicit FakeSlowProvider(std::chrono::milliseconds latency,
+                              std::string name = "FakeSlow",
+                              int priority = 1,
+                              double price = 10.0)
+        : latency_(latency), name_(std::move(name)), priority_(priority), price_(price) {}
+
+    std::optional<MarketTick> get_realtime_quote(const Symbol& symbol) override {
+        std::this_thread::sleep_for(latency_);
+        MarketTick tick{};
+        tick.symbol_id = symbol.id();
+        tick.price = price_;
+        return tick;
+    }
+
+    std::vector<OHLCV> get_kline_data(const Symbol&, KlinePeriod, int) override { return {}; }
+
+    std::string get_name() const override { return name_; }
+    int get_priority() const override { return priority_; }
+    int get_rate_limit() const override { return 1000; }
+    bool health_check() override { return true; }
+
+private:
+    std::chrono::milliseconds latency_;
+    std::string name_;
+    int priority_;
+    double price_;
+};
+
+// 模拟上游返回 429 的提供者
+class FakeThrottledProvider : public DataProvider {
+public:
+    std::optional<MarketTick> get_realtime_quote(const Symbol&) override {
+        calls++;
+        note_http_status(429, 0);
+        return std::nullopt;
+    }
+
+    std::vector<OHLCV> get_kline_data(const Symbol&, KlinePeriod, int) override { return {}; }
+
+    std::string get_name() const override { return "Throttled"; }
+    int get_priority() const override { return 1; }
+    int get_rate_limit() const override { return 1000; }
+    bool health_check() override { return true; }
+
+    int calls = 0;
+};
+
+// 支持批量请求的提供者，记录每次批量调用的大小
+class FakeBatchProvider : public DataProvider {
+public:
+    explicit FakeBatchProvider(size_t max_batch_size) : max_batch_size_(max_batch_size) {}
+
+    std::optional<MarketTick> get_realtime_quote(const Symbol& symbol) override {
+        return get_realtime_quotes(std::span<const Symbol>(&symbol, 1)).front();
+    }
+
+    std::vector<std::optional<MarketTick>> get_realtime_quotes(
+        std::span<const Symbol> symbols) override {
+        batch_sizes.push_back(symbols.size());
+        std::vector<std::optional<MarketTick>> ticks;
+        for (const auto& symbol : symbols) {
+            MarketTick tick{};
+            tick.symbol_id = symbol.id();
+            tick.price = 10.0;
+            ticks.push_back(tick);
+        }
+        return ticks;
+    }
+
+    std::vector<OHLCV> get_kline_data(const Symbol&, KlinePeriod, int) override { return {}; }
+
+    std::string get_name() const override { return "FakeBatch"; }
+    int get_priority() const override { return 1; }
+    int get_rate_limit() const override { return 1000; }
+    size_t get_max_batch_size() const override { return max_batch_size_; }
+    bool health_check() override { return true; }
+
+    std::vector<size_t> batch_sizes;
+
+private:
+    size_t max_batch_size_;
 };
 
 class DataStrategyTest : public ::testing::Test {
@@ -95,6 +190,63 @@ TEST_F(DataStrategyTest, WeightedRandomStrategy) {
     EXPECT_EQ(strategy.get_strategy_name(), "WeightedRandom");
 }
 
+// 加权随机策略应返回完整的候选列表，并偏向健康且低延迟的提供者
+TEST_F(DataStrategyTest, WeightedRandomStrategyPrefersHealthyProviders) {
+    WeightedRandomStrategy strategy;
+
+    std::vector<ProviderHealth> health(3);
+    health[0].status = ProviderStatus::DEGRADED;
+    health[0].success_rate = 0.5;
+    health[0].avg_response_time_ms = 800;
+    health[1].status = ProviderStatus::HEALTHY;
+    health[1].success_rate = 1.0;
+    health[1].avg_response_time_ms = 20;
+    health[2].status = ProviderStatus::HEALTHY;
+    health[2].success_rate = 0.9;
+    health[2].avg_response_time_ms = 200;
+
+    const int trials = 2000;
+    std::map<std::string, int> first_choice;
+    for (int i = 0; i < trials; ++i) {
+        auto selected =
+            strategy.select_providers_with_health(DataType::REALTIME_QUOTE, providers_, health);
+        ASSERT_EQ(selected.size(), providers_.size());
+        first_choice[selected[0]->get_name()]++;
+    }
+
+    EXPECT_GT(first_choice["Provider2"], trials * 8 / 10);
+    EXPECT_LT(first_choice["Provider1"], first_choice["Provider3"]);
+}
+
+// 测试对冲请求策略
+TEST_F(DataStrategyTest, HedgedStrategy) {
+    HedgedStrategy strategy;
+
+    auto selected = strategy.select_providers(DataType::REALTIME_QUOTE, providers_);
+
+    ASSERT_EQ(selected.size(), 3);
+    EXPECT_EQ(selected[0]->get_priority(), 1);
+    EXPECT_EQ(selected[2]->get_priority(), 3);
+    ASSERT_TRUE(strategy.hedge_policy().has_value());
+    EXPECT_EQ(strategy.get_strategy_name(), "Hedged");
+}
+
+TEST(LatencyHistogramTest, Percentile) {
+    LatencyHistogram histogram;
+    EXPECT_FALSE(histogram.percentile(0.5).has_value());
+
+    for (int i = 0; i < 90; ++i) {
+        histogram.record(5);
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(900);
+    }
+
+    EXPECT_EQ(histogram.sample_count(), 100);
+    EXPECT_EQ(histogram.percentile(0.5), 6);
+    EXPECT_EQ(histogram.percentile(0.99), 1000);
+}
+
 // 测试数据聚合器
 class DataAggregatorTest : public DataStrategyTest {
 protected:
@@ -108,6 +260,9 @@ protected:
 
         // 设置默认策略
         aggregator_.set_strategy(std::make_unique<FailoverStrategy>());
+
+        // 这些用例验证提供者路由，缓存另有专门的用例
+        aggregator_.set_cache_config({.enabled = false});
     }
 
     DataAggregator aggregator_;
@@ -118,7 +273,7 @@ TEST_F(DataAggregatorTest, BasicFunctionality) {
 
     // 准备测试数据
     MarketTick expected_tick;
-    expected_tick.symbol = test_symbol.to_string();
+    expected_tick.symbol_id = test_symbol.id();
     expected_tick.price = 10.5;
     expected_tick.volume = 1000;
     expected_tick.timestamp = std::chrono::system_clock::now();
@@ -130,7 +285,7 @@ TEST_F(DataAggregatorTest, BasicFunctionality) {
     // 测试获取实时行情
     auto result = aggregator_.get_realtime_quote(test_symbol);
     ASSERT_TRUE(result.has_value());
-    EXPECT_EQ(result->symbol, expected_tick.symbol);
+    EXPECT_EQ(result->symbol_id, expected_tick.symbol_id);
     EXPECT_EQ(result->price, expected_tick.price);
 }
 
@@ -138,7 +293,7 @@ TEST_F(DataAggregatorTest, FailoverBehavior) {
     Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
 
     MarketTick expected_tick;
-    expected_tick.symbol = test_symbol.to_string();
+    expected_tick.symbol_id = test_symbol.id();
     expected_tick.price = 10.5;
 
     // 设置期望：第一个提供者失败，第二个成功
@@ -169,6 +324,55 @@ TEST_F(DataAggregatorTest, AllProvidersFail) {
     EXPECT_FALSE(result.has_value());
 }
 
+TEST_F(DataAggregatorTest, BatchQuotesFailover) {
+    std::vector<Symbol> symbols = {Symbol("000001", Market::SZ, SecurityType::STOCK),
+                                   Symbol("600000", Market::SH, SecurityType::STOCK)};
+
+    MarketTick tick1;
+    tick1.symbol_id = symbols[0].id();
+    tick1.price = 10.5;
+    MarketTick tick2;
+    tick2.symbol_id = symbols[1].id();
+    tick2.price = 7.2;
+
+    // 第一个提供者只返回第一只证券，缺失的交给第二个提供者补齐
+    EXPECT_CALL(*provider1_, get_realtime_quote(symbols[0])).WillOnce(testing::Return(tick1));
+    EXPECT_CALL(*provider1_, get_realtime_quote(symbols[1]))
+        .WillOnce(testing::Return(std::nullopt));
+    EXPECT_CALL(*provider2_, get_realtime_quote(symbols[1])).WillOnce(testing::Return(tick2));
+    EXPECT_CALL(*provider3_, get_realtime_quote(testing::_)).Times(0);
+
+    auto ticks = aggregator_.get_realtime_quotes(symbols);
+    ASSERT_EQ(ticks.size(), 2);
+    ASSERT_TRUE(ticks[0].has_value());
+    ASSERT_TRUE(ticks[1].has_value());
+    EXPECT_EQ(ticks[0]->price, 10.5);
+    EXPECT_EQ(ticks[1]->price, 7.2);
+}
+
+TEST(DataAggregatorBatchTest, SplitsUniverseIntoProviderSizedChunks) {
+    auto provider = std::make_shared<FakeBatchProvider>(2);
+
+    DataAggregator aggregator;
+    aggregator.register_provider(provider);
+    aggregator.set_strategy(std::make_unique<FailoverStrategy>());
+
+    std::vector<Symbol> symbols;
+    for (int i = 0; i < 5; ++i) {
+        symbols.emplace_back("60000" + std::to_string(i), Market::SH, SecurityType::STOCK);
+    }
+
+    auto ticks = aggregator.get_realtime_quotes(symbols);
+
+    ASSERT_EQ(ticks.size(), symbols.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        ASSERT_TRUE(ticks[i].has_value());
+        EXPECT_EQ(ticks[i]->symbol_id, symbols[i].id());
+    }
+    EXPECT_EQ(provider->batch_sizes, (std::vector<size_t>{2, 2, 1}));
+    EXPECT_EQ(aggregator.get_statistics().total_requests, 3);
+}
+
 TEST_F(DataAggregatorTest, HealthMonitoring) {
     // 测试健康状态监控
     aggregator_.update_provider_health();
@@ -183,6 +387,262 @@ TEST_F(DataAggregatorTest, HealthMonitoring) {
     }
 }
 
+TEST_F(DataAggregatorTest, HealthTrackedOnEveryCall) {
+    Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
+
+    MarketTick tick;
+    tick.symbol_id = test_symbol.id();
+    tick.price = 10.5;
+
+    EXPECT_CALL(*provider1_, get_realtime_quote(testing::_))
+        .WillOnce([this](const Symbol&) { return provider1_->fail_request(); });
+    EXPECT_CALL(*provider2_, get_realtime_quote(testing::_)).WillOnce(testing::Return(tick));
+
+    ASSERT_TRUE(aggregator_.get_realtime_quote(test_symbol).has_value());
+
+    auto health = aggregator_.get_provider_health();
+    EXPECT_EQ(health["Provider1"].status, ProviderStatus::DEGRADED);
+    EXPECT_EQ(health["Provider1"].consecutive_failures, 1);
+    EXPECT_EQ(health["Provider1"].success_rate, 0.0);
+    EXPECT_EQ(health["Provider2"].status, ProviderStatus::HEALTHY);
+    EXPECT_EQ(health["Provider2"].success_rate, 1.0);
+    EXPECT_EQ(health["Provider3"].status, ProviderStatus::UNKNOWN);
+}
+
+TEST_F(DataAggregatorTest, CircuitBreakerOpensAndRecovers) {
+    CircuitBreakerConfig config;
+    config.failure_threshold = 2;
+    config.open_duration = std::chrono::milliseconds(50);
+    aggregator_.set_circuit_breaker_config(config);
+
+    Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
+    MarketTick tick;
+    tick.symbol_id = test_symbol.id();
+    tick.price = 10.5;
+
+    // 连续失败两次后熔断，第三次请求不再发往 Provider1
+    EXPECT_CALL(*provider1_, get_realtime_quote(testing::_))
+        .Times(2)
+        .WillRepeatedly([this](const Symbol&) { return provider1_->fail_request(); });
+    EXPECT_CALL(*provider2_, get_realtime_quote(testing::_))
+        .WillRepeatedly(testing::Return(tick));
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(aggregator_.get_realtime_quote(test_symbol).has_value());
+    }
+
+    EXPECT_EQ(aggregator_.get_provider_health()["Provider1"].status, ProviderStatus::FAILED);
+    EXPECT_GE(aggregator_.get_statistics().short_circuited_requests, 1);
+    EXPECT_EQ(aggregator_.get_statistics().provider_failure_count["Provider1"], 2);
+
+    // 冷却期内不探测
+    EXPECT_CALL(*provider1_, health_check()).WillOnce(testing::Return(true));
+    aggregator_.update_provider_health();
+    EXPECT_EQ(aggregator_.get_provider_health()["Provider1"].status, ProviderStatus::FAILED);
+
+    // 冷却期过后半开探测成功，熔断器闭合
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    aggregator_.update_provider_health();
+    EXPECT_NE(aggregator_.get_provider_health()["Provider1"].status, ProviderStatus::FAILED);
+}
+
+// 上游正常答复的空结果（停牌、退市或未知证券）不计入失败，不会触发熔断
+TEST_F(DataAggregatorTest, EmptyAnswersDoNotTripBreaker) {
+    CircuitBreakerConfig config;
+    config.failure_threshold = 2;
+    aggregator_.set_circuit_breaker_config(config);
+
+    MarketTick tick;
+    tick.price = 10.5;
+    EXPECT_CALL(*provider1_, get_realtime_quote(testing::_))
+        .Times(5)
+        .WillRepeatedly(testing::Return(std::nullopt));
+    EXPECT_CALL(*provider2_, get_realtime_quote(testing::_))
+        .WillRepeatedly(testing::Return(tick));
+
+    Symbol suspended("600001", Market::SH);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(aggregator_.get_realtime_quote(suspended).has_value());
+    }
+
+    auto health = aggregator_.get_provider_health();
+    EXPECT_NE(health["Provider1"].status, ProviderStatus::FAILED);
+    EXPECT_EQ(health["Provider1"].consecutive_failures, 0);
+    auto stats = aggregator_.get_statistics();
+    EXPECT_EQ(stats.short_circuited_requests, 0);
+    EXPECT_EQ(stats.provider_failure_count.count("Provider1"), 0);
+}
+
+// 熔断前已发出的慢请求在冷却期内失败，不应推迟半开探测
+TEST_F(DataAggregatorTest, LateFailureDoesNotExtendOpenBreaker) {
+    CircuitBreakerConfig config;
+    config.failure_threshold = 1;
+    config.open_duration = std::chrono::milliseconds(150);
+    aggregator_.set_circuit_breaker_config(config);
+
+    auto fail_after = [this](int ms) {
+        return [this, ms](const Symbol&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+            return provider1_->fail_request();
+        };
+    };
+    MarketTick primary_tick;
+    primary_tick.price = 1.0;
+    MarketTick backup_tick;
+    backup_tick.price = 2.0;
+    EXPECT_CALL(*provider1_, get_realtime_quote(testing::_))
+        .WillOnce(fail_after(10))
+        .WillOnce(fail_after(120))
+        .WillRepeatedly(testing::Return(primary_tick));
+    EXPECT_CALL(*provider2_, get_realtime_quote(testing::_))
+        .WillRepeatedly(testing::Return(backup_tick));
+
+    // 两个请求使用不同证券，避免被合并为一次上游调用
+    auto start = std::chrono::steady_clock::now();
+    std::thread fast([&] { aggregator_.get_realtime_quote(Symbol("000001", Market::SZ)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    std::thread slow([&] { aggregator_.get_realtime_quote(Symbol("000002", Market::SZ)); });
+    fast.join();
+    slow.join();
+
+    // 第一次失败后冷却至约 160ms；慢请求在约 122ms 失败，不再把冷却推迟到约 270ms
+    std::this_thread::sleep_until(start + std::chrono::milliseconds(200));
+    auto result = aggregator_.get_realtime_quote(Symbol("000003", Market::SZ));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->price, 1.0);
+    EXPECT_EQ(aggregator_.get_statistics().provider_failure_count["Provider1"], 2);
+}
+
+TEST(TokenBucketTest, AllowsBurstThenThrottles) {
+    TokenBucket bucket;
+    // 60 次/分钟，5 秒突发窗口 => 最多连续取 5 个令牌
+    bucket.configure(60, std::chrono::seconds(5));
+
+    int granted = 0;
+    for (int i = 0; i < 10; ++i) {
+        if (bucket.try_acquire()) {
+            granted++;
+        }
+    }
+    EXPECT_EQ(granted, 5);
+
+    // 不限流时总是放行
+    bucket.configure(0, std::chrono::seconds(5));
+    EXPECT_TRUE(bucket.try_acquire());
+}
+
+TEST_F(DataAggregatorTest, RateLimitSkipsToNextProvider) {
+    aggregator_.set_rate_limit_config({.enabled = true, .burst_window = std::chrono::seconds(1)});
+
+    Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
+    MarketTick tick;
+    tick.symbol_id = test_symbol.id();
+    tick.price = 10.5;
+
+    // Provider1 为 100 次/分钟，1 秒窗口只够一次请求
+    EXPECT_CALL(*provider1_, get_realtime_quote(testing::_)).WillOnce(testing::Return(tick));
+    EXPECT_CALL(*provider2_, get_realtime_quote(testing::_)).WillOnce(testing::Return(tick));
+
+    ASSERT_TRUE(aggregator_.get_realtime_quote(test_symbol).has_value());
+    ASSERT_TRUE(aggregator_.get_realtime_quote(test_symbol).has_value());
+
+    auto stats = aggregator_.get_statistics();
+    EXPECT_EQ(stats.rate_limited_skips, 1);
+    EXPECT_EQ(stats.provider_usage_count["Provider1"], 1);
+    EXPECT_EQ(stats.provider_usage_count["Provider2"], 1);
+}
+
+TEST(DataAggregatorRateLimitTest, UpstreamThrottleMarksRateLimited) {
+    auto throttled = std::make_shared<FakeThrottledProvider>();
+
+    DataAggregator aggregator;
+    aggregator.register_provider(throttled);
+    aggregator.register_provider(
+        std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(0), "Backup", 2));
+    aggregator.set_strategy(std::make_unique<FailoverStrategy>());
+
+    Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
+    ASSERT_TRUE(aggregator.get_realtime_quote(test_symbol).has_value());
+    ASSERT_TRUE(aggregator.get_realtime_quote(test_symbol).has_value());
+
+    // 收到 429 后进入冷却，第二次请求不再打到被限流的提供者
+    EXPECT_EQ(throttled->calls, 1);
+    EXPECT_EQ(aggregator.get_provider_health()["Throttled"].status, ProviderStatus::RATE_LIMITED);
+}
+
+TEST(ShardedCacheTest, ExpiresAndEvicts) {
+    using IntCache = ShardedCache<int, int>;
+    IntCache cache(IntCache::SHARD_COUNT);
+
+    cache.put(1, 100, std::chrono::milliseconds(20));
+    ASSERT_EQ(cache.get(1), 100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_FALSE(cache.get(1).has_value());
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 1);
+
+    // 每个分片只容纳一个条目，写入远多于分片数的键必然触发淘汰
+    for (int i = 0; i < 100; ++i) {
+        cache.put(i, i, std::chrono::seconds(10));
+    }
+    EXPECT_GE(cache.evictions(), 100 - IntCache::SHARD_COUNT);
+    EXPECT_EQ(cache.get(99), 99);
+}
+
+// 只有类型、周期或条数不同的键也应得到不同的哈希值
+TEST(RequestKeyHashTest, DistinguishesFieldsOfSameSymbol) {
+    Symbol symbol("000001", Market::SZ);
+    std::vector<KlinePeriod> periods = {KlinePeriod::MIN_1,
+                                        KlinePeriod::MIN_5,
+                                        KlinePeriod::MIN_15,
+                                        KlinePeriod::MIN_30,
+                                        KlinePeriod::HOUR_1,
+                                        KlinePeriod::HOUR_4,
+                                        KlinePeriod::DAY_1,
+                                        KlinePeriod::WEEK_1,
+                                        KlinePeriod::MONTH_1};
+
+    std::unordered_set<size_t> hashes;
+    size_t keys = 0;
+    for (auto type : {DataType::REALTIME_QUOTE, DataType::KLINE_DATA}) {
+        for (auto period : periods) {
+            for (int limit = 0; limit <= 500; ++limit) {
+                hashes.insert(RequestKeyHash()(
+                    {.type = type, .symbol = symbol, .period = period, .limit = limit}));
+                keys++;
+            }
+        }
+    }
+    EXPECT_EQ(hashes.size(), keys);
+}
+
+TEST_F(DataAggregatorTest, CacheServesRecentQuotes) {
+    aggregator_.set_cache_config({.enabled = true, .quote_ttl = std::chrono::milliseconds(50)});
+
+    Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
+    MarketTick tick;
+    tick.symbol_id = test_symbol.id();
+    tick.price = 10.5;
+
+    // 有效期内的重复请求与批量请求都由缓存返回
+    EXPECT_CALL(*provider1_, get_realtime_quote(testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Return(tick));
+
+    ASSERT_TRUE(aggregator_.get_realtime_quote(test_symbol).has_value());
+    ASSERT_TRUE(aggregator_.get_realtime_quote(test_symbol).has_value());
+    std::vector<Symbol> symbols = {test_symbol};
+    ASSERT_TRUE(aggregator_.get_realtime_quotes(symbols)[0].has_value());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    ASSERT_TRUE(aggregator_.get_realtime_quote(test_symbol).has_value());
+
+    auto stats = aggregator_.get_statistics();
+    EXPECT_EQ(stats.cache_hits, 2);
+    EXPECT_EQ(stats.cache_misses, 2);
+    EXPECT_EQ(stats.total_requests, 2);
+}
+
 TEST_F(DataAggregatorTest, Statistics) {
     auto stats = aggregator_.get_statistics();
 
@@ -197,9 +657,12 @@ TEST_F(DataAggregatorTest, PerformanceTest) {
     Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
 
     MarketTick test_tick;
-    test_tick.symbol = test_symbol.to_string();
+    test_tick.symbol_id = test_symbol.id();
     test_tick.price = 10.5;
 
+    // 只衡量聚合器自身开销，关闭客户端限流
+    aggregator_.set_rate_limit_config({.enabled = false});
+
     // 设置提供者总是成功
     EXPECT_CALL(*provider1_, get_realtime_quote(testing::_))
         .WillRepeatedly(testing::Return(test_tick));
@@ -222,4 +685,175 @@ TEST_F(DataAggregatorTest, PerformanceTest) {
     EXPECT_LT(avg_time_per_request, 1000.0);  // 少于1ms每次请求
 }
 
+// 并发请求不应被聚合器的锁串行化
+TEST(DataAggregatorConcurrencyTest, ConcurrentRequestsDoNotSerialize) {
+    constexpr auto latency = std::chrono::milliseconds(100);
+    constexpr int thread_count = 8;
+
+    DataAggregator aggregator;
+    aggregator.register_provider(std::make_shared<FakeSlowProvider>(latency));
+    aggregator.set_strategy(std::make_unique<FailoverStrategy>());
+
+    std::atomic<int> success_count{0};
+
+    auto start = std::chrono::steady_clock::now();
+
+    // 每个线程请求不同的证券，避免被单飞合并
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i] {
+            Symbol symbol("00000" + std::to_string(i), Market::SZ, SecurityType::STOCK);
+            if (aggregator.get_realtime_quote(symbol)) {
+                success_count++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(success_count.load(), thread_count);
+    // 串行执行需要 thread_count * latency，并发执行应接近单次调用延迟
+    EXPECT_LT(elapsed, latency * (thread_count / 2));
+
+    auto stats = aggregator.get_statistics();
+    EXPECT_EQ(stats.total_requests, thread_count);
+    EXPECT_EQ(stats.successful_requests, thread_count);
+    EXPECT_EQ(stats.provider_usage_count["FakeSlow"], thread_count);
+}
+
+// 并发的相同请求只发出一次上游调用
+TEST(DataAggregatorConcurrencyTest, IdenticalRequestsAreCoalesced) {
+    constexpr auto latency = std::chrono::milliseconds(100);
+    constexpr int thread_count = 8;
+
+    DataAggregator aggregator;
+    aggregator.register_provider(std::make_shared<FakeSlowProvider>(latency));
+    aggregator.set_strategy(std::make_unique<FailoverStrategy>());
+
+    Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
+    std::atomic<int> success_count{0};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&] {
+            if (aggregator.get_realtime_quote(test_symbol)) {
+                success_count++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(success_count.load(), thread_count);
+
+    auto stats = aggregator.get_statistics();
+    EXPECT_EQ(stats.total_requests + stats.coalesced_requests, thread_count);
+    EXPECT_LT(stats.provider_usage_count["FakeSlow"], thread_count);
+}
+
+// 主提供者迟迟不返回时，对冲请求应由下一个提供者先返回
+TEST(DataAggregatorHedgeTest, HedgeFiresWhenPrimaryIsSlow) {
+    HedgePolicy policy;
+    policy.min_delay = std::chrono::milliseconds(10);
+    policy.default_delay = std::chrono::milliseconds(30);
+    policy.max_in_flight = 1;  // 主请求不计入对冲上限
+
+    DataAggregator aggregator;
+    aggregator.register_provider(
+        std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(500), "Slow", 1, 10.0));
+    aggregator.register_provider(
+        std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(5), "Fast", 2, 20.0));
+    aggregator.set_strategy(std::make_unique<HedgedStrategy>(policy));
+
+    Symbol test_symbol("000001", Market::SZ, SecurityType::STOCK);
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = aggregator.get_realtime_quote(test_symbol);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->price, 20.0);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+
+    auto stats = aggregator.get_statistics();
+    EXPECT_EQ(stats.hedged_requests, 1);
+    EXPECT_EQ(stats.hedge_wins, 1);
+    EXPECT_EQ(stats.provider_usage_count["Fast"], 1);
+}
+
+// 对冲请求数达到上限时其他请求不再对冲，等待主提供者返回
+TEST(DataAggregatorHedgeTest, HedgeCappedByInFlightHedges) {
+    HedgePolicy policy;
+    policy.min_delay = std::chrono::milliseconds(10);
+    policy.default_delay = std::chrono::milliseconds(10);
+    policy.max_in_flight = 1;
+
+    DataAggregator aggregator;
+    aggregator.register_provider(
+        std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(150), "Slow", 1, 10.0));
+    aggregator.register_provider(
+        std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(300), "Backup", 2, 20.0));
+    aggregator.set_strategy(std::make_unique<HedgedStrategy>(policy));
+
+    // 第一个请求的对冲占满名额，第二个请求只能等待自己的主请求
+    std::optional<MarketTick> first;
+    std::thread hedged(
+        [&] { first = aggregator.get_realtime_quote(Symbol("000001", Market::SZ)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    auto second = aggregator.get_realtime_quote(Symbol("000002", Market::SZ));
+    hedged.join();
+
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->price, 10.0);
+    EXPECT_EQ(aggregator.get_statistics().hedged_requests, 1);
+}
+
+// 主请求很快返回时后台请求也应及时回收，不随请求数增长
+TEST(DataAggregatorHedgeTest, FastRequestsDoNotAccumulateAttempts) {
+    DataAggregator aggregator;
+    aggregator.register_provider(
+        std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(0), "Primary", 1, 10.0));
+    aggregator.register_provider(
+        std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(0), "Backup", 2, 20.0));
+    aggregator.set_strategy(std::make_unique<HedgedStrategy>());
+    aggregator.set_cache_config({.enabled = false});
+    aggregator.set_rate_limit_config({.enabled = false});
+
+    Symbol test_symbol("000001", Market::SZ);
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_TRUE(aggregator.get_realtime_quote(test_symbol).has_value());
+    }
+
+    auto stats = aggregator.get_statistics();
+    EXPECT_EQ(stats.hedged_requests, 0);
+    EXPECT_LE(stats.pending_attempts, 4);
+}
+
+// 析构时等待落后的请求结束，不留下仍在使用提供者的线程
+TEST(DataAggregatorHedgeTest, DestructorWaitsForLosingAttempts) {
+    HedgePolicy policy;
+    policy.min_delay = std::chrono::milliseconds(10);
+    policy.default_delay = std::chrono::milliseconds(10);
+
+    auto slow = std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(200), "Slow", 1);
+    {
+        DataAggregator aggregator;
+        aggregator.register_provider(slow);
+        aggregator.register_provider(
+            std::make_shared<FakeSlowProvider>(std::chrono::milliseconds(5), "Fast", 2, 20.0));
+        aggregator.set_strategy(std::make_unique<HedgedStrategy>(policy));
+
+        auto result =
+            aggregator.get_realtime_quote(Symbol("000001", Market::SZ, SecurityType::STOCK));
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(result->price, 20.0);
+    }
+    EXPECT_EQ(slow.use_count(), 1);
+}
+
 }  // namespace cppshares::data::tests
\ No newline at end of file
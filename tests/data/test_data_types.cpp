@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <thread>
+
 #include "cppshares/data/data_types.hpp"
+#include "cppshares/data/market_data.hpp"
 
 namespace cppshares::data::tests {
 
@@ -18,12 +21,12 @@ TEST_F(DataTypesTest, SymbolParsing) {
     Symbol shanghai_index("000001", Market::SH, SecurityType::INDEX);
     Symbol sh_etf("510050", Market::SH, SecurityType::ETF);
 
-    EXPECT_EQ(ping_an.code, "000001");
-    EXPECT_EQ(ping_an.market, Market::SZ);
-    EXPECT_EQ(ping_an.type, SecurityType::STOCK);
+    EXPECT_EQ(ping_an.code(), "000001");
+    EXPECT_EQ(ping_an.market(), Market::SZ);
+    EXPECT_EQ(ping_an.type(), SecurityType::STOCK);
 
-    EXPECT_EQ(shanghai_index.market, Market::SH);
-    EXPECT_EQ(shanghai_index.type, SecurityType::INDEX);
+    EXPECT_EQ(shanghai_index.market(), Market::SH);
+    EXPECT_EQ(shanghai_index.type(), SecurityType::INDEX);
 
     // 测试符号相等性
     Symbol ping_an_copy("000001", Market::SZ, SecurityType::STOCK);
@@ -31,6 +34,106 @@ TEST_F(DataTypesTest, SymbolParsing) {
     EXPECT_NE(ping_an, shanghai_index);  // 不同市场
 }
 
+// 测试符号打包、解析与哈希
+TEST_F(DataTypesTest, SymbolPackingAndParsing) {
+    Symbol bond("113050", Market::SH, SecurityType::CONVERTIBLE);
+    EXPECT_EQ(Symbol::parse(bond.to_string()), bond);
+    EXPECT_EQ(bond.to_string(), "113050.SH.CONVERTIBLE");
+
+    Symbol brk("BRK-b", Market::US);
+    EXPECT_EQ(brk.code(), "BRK-b");
+    EXPECT_EQ(Symbol::parse("BRK-b.US.STOCK"), brk);
+    EXPECT_EQ(Symbol("123456789", Market::HK).code(), "123456789");
+
+    // 无法解析的市场与类型回退为沪市股票
+    EXPECT_EQ(Symbol::parse("600000"), Symbol("600000", Market::SH));
+    EXPECT_EQ(Symbol::parse("600000.XX.YY"), Symbol("600000", Market::SH));
+
+    EXPECT_THROW(Symbol("1234567890", Market::SH), std::invalid_argument);
+    EXPECT_THROW(Symbol("60 000", Market::SH), std::invalid_argument);
+    EXPECT_FALSE(Symbol::is_packable("60 000"));
+    EXPECT_FALSE(Symbol::try_pack("1234567890", Market::SH).has_value());
+    EXPECT_EQ(Symbol::try_pack("000001", Market::SZ), Symbol("000001", Market::SZ));
+
+    // 代码前缀相同或仅市场不同的证券键与哈希都不同
+    std::hash<Symbol> hasher;
+    EXPECT_NE(Symbol("60000", Market::SH).key(), Symbol("600000", Market::SH).key());
+    EXPECT_NE(hasher(Symbol("000001", Market::SZ)), hasher(Symbol("000001", Market::SH)));
+}
+
+// 解析从不抛出异常：旧实现能接受的输入仍然得到证券
+TEST_F(DataTypesTest, SymbolParseNeverThrows) {
+    for (auto input : {"600000.SH", "600000.SH.STOCK.EXTRA", "600 000", "BRK.B", "",
+                       "...", "ABCDEFGHIJKL.US.STOCK", "000001.SZ.", "^GSPC.US.INDEX"}) {
+        EXPECT_NO_THROW(Symbol::parse(input)) << input;
+    }
+    EXPECT_EQ(Symbol::parse("600000.SH"), Symbol("600000", Market::SH));
+    EXPECT_EQ(Symbol::parse("000001.SZ"), Symbol("000001", Market::SZ));
+    EXPECT_EQ(Symbol::parse("600 000"), Symbol("600000", Market::SH));
+    EXPECT_EQ(Symbol::parse("ABCDEFGHIJKL.US.STOCK"), Symbol("ABCDEFGHI", Market::US));
+    EXPECT_EQ(Symbol::parse("^GSPC.US.INDEX"), Symbol("GSPC", Market::US, SecurityType::INDEX));
+}
+
+// 严格解析不截断代码；注册表中无法打包的名称不会被还原成别的证券
+TEST_F(DataTypesTest, StrictParseRejectsUnpackableCodes) {
+    EXPECT_EQ(Symbol::try_parse("600000.SH"), Symbol("600000", Market::SH));
+    EXPECT_EQ(Symbol::try_parse("BRK-b.US.STOCK"), Symbol("BRK-b", Market::US));
+    EXPECT_FALSE(Symbol::try_parse("^GSPC.US.INDEX").has_value());
+    EXPECT_FALSE(Symbol::try_parse("ABCDEFGHIJKL.US.STOCK").has_value());
+
+    auto id = utils::SymbolRegistry::global().intern("^GSPC.US.INDEX");
+    EXPECT_THROW(Symbol::from_id(id), std::runtime_error);
+    EXPECT_EQ(security_type_of(id), SecurityType::INDEX);
+}
+
+// 测试证券 id：按打包键缓存，各线程得到同一 id
+TEST_F(DataTypesTest, SymbolIdIsCachedPerKey) {
+    Symbol moutai("600519", Market::SH);
+    auto id = moutai.id();
+    EXPECT_EQ(moutai.id(), id);
+    EXPECT_EQ(utils::SymbolRegistry::global().find("600519.SH.STOCK"), id);
+    EXPECT_EQ(Symbol::from_id(id), moutai);
+
+    SymbolId other_thread_id = INVALID_SYMBOL_ID;
+    std::thread([&] { other_thread_id = Symbol("600519", Market::SH).id(); }).join();
+    EXPECT_EQ(other_thread_id, id);
+    EXPECT_NE(Symbol("600519", Market::SH, SecurityType::ETF).id(), id);
+}
+
+// 测试各证券类型的报价精度
+TEST_F(DataTypesTest, PriceTickBySecurityType) {
+    EXPECT_EQ(price_tick(SecurityType::STOCK), utils::Price::from_double(0.01));
+    EXPECT_EQ(price_tick(SecurityType::ETF), utils::Price::from_double(0.001));
+    EXPECT_EQ(price_tick(SecurityType::OPTION), utils::Price::from_raw(1));
+
+    EXPECT_EQ(to_price(10.126, SecurityType::STOCK).to_string(), "10.1300");
+    EXPECT_EQ(to_price(2.3456, SecurityType::ETF), utils::Price::from_double(2.346));
+    auto option_price = to_price(0.1234, SecurityType::OPTION);
+    EXPECT_EQ(option_price.to_string(price_decimals(SecurityType::OPTION)), "0.1234");
+}
+
+// 行情与K线的定点价格按证券自身的最小报价单位取整
+TEST_F(DataTypesTest, FixedPricesSnapToSecurityTick) {
+    MarketTick stock_tick{};
+    stock_tick.symbol_id = Symbol("600000", Market::SH, SecurityType::STOCK).id();
+    stock_tick.price = 10.126;
+    EXPECT_EQ(stock_tick.fixed_price(), utils::Price::from_double(10.13));
+
+    MarketTick etf_tick{};
+    etf_tick.symbol_id = Symbol("510050", Market::SH, SecurityType::ETF).id();
+    etf_tick.price = 2.3456;
+    etf_tick.bid_price = 2.3454;
+    EXPECT_EQ(etf_tick.fixed_price(), utils::Price::from_double(2.346));
+    EXPECT_EQ(etf_tick.fixed_bid_price(), utils::Price::from_double(2.345));
+    EXPECT_EQ(etf_tick.fixed_price(SecurityType::OPTION), utils::Price::from_double(2.3456));
+
+    OHLCV bar{};
+    bar.symbol_id = Symbol("000300", Market::SH, SecurityType::INDEX).id();
+    bar.close = 3456.7891;
+    EXPECT_EQ(bar.fixed_close(), utils::Price::from_double(3456.7891));
+    EXPECT_EQ(bar.fixed_close(SecurityType::STOCK), utils::Price::from_double(3456.79));
+}
+
 // 测试枚举基本功能
 TEST_F(DataTypesTest, EnumBasics) {
     // 测试枚举可以正常赋值和比较
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <cstdio>
 #include <cstdlib>
 #include <iomanip>
+#include <sstream>
 
 #include "cppshares/data/data_types.hpp"
 #include "cppshares/data/providers/eastmoney_provider.hpp"
@@ -38,6 +40,23 @@ TEST_F(ProvidersTest, SinaProviderBasics) {
     // EXPECT_TRUE(provider.health_check());
 }
 
+// 批量行情中停牌（现价为 0）的行视为无数据
+TEST_F(ProvidersTest, SinaBatchSkipsSuspendedRows) {
+    std::vector<Symbol> symbols = {Symbol("600000", Market::SH), Symbol("000001", Market::SZ)};
+    std::string response =
+        "var hq_str_sh600000=\"浦发银行,10.010,10.000,10.050,10.100,9.980,10.040,10.050,"
+        "1234500,12400000.000,100\";\n"
+        "var hq_str_sz000001=\"平安银行,0.000,11.200,0.000,0.000,0.000,0.000,0.000,0,0.000,0\";\n";
+
+    auto ticks = SinaProvider::parse_batch_realtime_response(response, symbols);
+    ASSERT_EQ(ticks.size(), 2);
+    ASSERT_TRUE(ticks[0].has_value());
+    EXPECT_DOUBLE_EQ(ticks[0]->price, 10.05);
+    EXPECT_EQ(ticks[0]->volume, 1234500);
+    EXPECT_NEAR(ticks[0]->change_amount, 0.05, 1e-9);
+    EXPECT_FALSE(ticks[1].has_value());
+}
+
 // 测试腾讯提供者
 TEST_F(ProvidersTest, TencentProviderBasics) {
     TencentProvider provider;
@@ -69,6 +88,33 @@ TEST_F(ProvidersTest, EastMoneyProviderBasics) {
     // EXPECT_TRUE(provider.health_check());
 }
 
+// 测试增量K线合并
+TEST_F(ProvidersTest, EastMoneyKlineMerge) {
+    auto bar = [](int day, double close) {
+        OHLCV ohlcv{};
+        ohlcv.timestamp = std::chrono::system_clock::time_point(std::chrono::hours(24 * day));
+        ohlcv.close = close;
+        return ohlcv;
+    };
+
+    std::vector<OHLCV> history = {bar(1, 10.0), bar(2, 11.0), bar(3, 12.0)};
+
+    // 最后一根尚未收盘的K线被替换，新K线追加在后
+    EXPECT_TRUE(EastMoneyProvider::merge_klines(history, {bar(3, 12.5), bar(4, 13.0)}));
+    ASSERT_EQ(history.size(), 4);
+    EXPECT_DOUBLE_EQ(history[2].close, 12.5);
+    EXPECT_DOUBLE_EQ(history[3].close, 13.0);
+
+    // 没有新数据时保持不变
+    EastMoneyProvider::merge_klines(history, {});
+    EXPECT_EQ(history.size(), 4);
+
+    // 新数据与历史之间可能有缺口时整体替换
+    EXPECT_FALSE(EastMoneyProvider::merge_klines(history, {bar(10, 20.0), bar(11, 21.0)}));
+    ASSERT_EQ(history.size(), 2);
+    EXPECT_DOUBLE_EQ(history.front().close, 20.0);
+}
+
 // 测试提供者优先级排序
 TEST_F(ProvidersTest, ProviderPriorities) {
     auto eastmoney = std::make_unique<EastMoneyProvider>();
@@ -98,9 +144,9 @@ TEST_F(ProvidersTest, ProviderPriorities) {
 TEST_F(ProvidersTest, SymbolBasicValidation) {
     for (const auto& symbol : test_symbols_) {
         // 基本符号验证
-        EXPECT_FALSE(symbol.code.empty());
-        EXPECT_NE(symbol.market, static_cast<Market>(-1));
-        EXPECT_NE(symbol.type, static_cast<SecurityType>(-1));
+        EXPECT_FALSE(symbol.code().empty());
+        EXPECT_NE(symbol.market(), static_cast<Market>(-1));
+        EXPECT_NE(symbol.type(), static_cast<SecurityType>(-1));
     }
 }
 
@@ -163,6 +209,80 @@ TEST_F(ProvidersTest, PerformanceBenchmark) {
     EXPECT_LT(avg_time, 10.0);  // 每次转换少于10微秒
 }
 
+// K线行解析基准：与原 stringstream + get_time + mktime 实现对比
+TEST_F(ProvidersTest, KlineRowParseBenchmark) {
+    // 按东方财富日K响应格式构造 10000 行
+    std::vector<std::string> rows;
+    rows.reserve(10000);
+    auto day = std::chrono::sys_days{std::chrono::year{1990} / 12 / 19};
+    for (int i = 0; i < 10000; ++i, day += std::chrono::days(1)) {
+        std::chrono::year_month_day date{day};
+        char row[128];
+        std::snprintf(row,
+                      sizeof(row),
+                      "%04d-%02u-%02u,%.2f,%.2f,%.2f,%.2f,%d,%.2f,2.76,1.14,0.12,0.64",
+                      static_cast<int>(date.year()),
+                      static_cast<unsigned>(date.month()),
+                      static_cast<unsigned>(date.day()),
+                      10.0 + i % 100 * 0.01,
+                      10.1 + i % 100 * 0.01,
+                      10.2 + i % 100 * 0.01,
+                      9.9 + i % 100 * 0.01,
+                      1000000 + i,
+                      1.2e9 + i);
+        rows.emplace_back(row);
+    }
+
+    auto legacy_parse = [](const std::string& row) {
+        std::vector<std::string> fields;
+        std::stringstream ss(row);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            fields.push_back(field);
+        }
+        OHLCV ohlcv{};
+        std::tm tm = {};
+        std::istringstream date_stream(fields[0]);
+        date_stream >> std::get_time(&tm, "%Y-%m-%d");
+        ohlcv.timestamp = std::chrono::system_clock::from_time_t(std::mktime(&tm));
+        ohlcv.open = std::stod(fields[1]);
+        ohlcv.close = std::stod(fields[2]);
+        ohlcv.high = std::stod(fields[3]);
+        ohlcv.low = std::stod(fields[4]);
+        ohlcv.volume = std::stoull(fields[5]);
+        ohlcv.amount = std::stod(fields[6]);
+        return ohlcv;
+    };
+
+    auto time_us = [&](auto&& parse) {
+        double checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& row : rows) {
+            checksum += parse(row);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_GT(checksum, 0);
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    };
+
+    auto legacy_us = time_us([&](const std::string& row) { return legacy_parse(row).close; });
+    auto fast_us = time_us([](const std::string& row) {
+        return EastMoneyProvider::parse_kline_row(row).value().close;
+    });
+
+    std::cout << "Kline row parse (10000 rows): legacy " << legacy_us << " us, from_chars "
+              << fast_us << " us" << std::endl;
+
+    // 日期按北京时间零点解释
+    auto first = EastMoneyProvider::parse_kline_row(rows.front());
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->timestamp,
+              std::chrono::sys_days{std::chrono::year{1990} / 12 / 19} - std::chrono::hours(8));
+    EXPECT_DOUBLE_EQ(first->close, 10.1);
+    EXPECT_FALSE(EastMoneyProvider::parse_kline_row("2024-13-01,1,1,1,1,1,1").has_value());
+    EXPECT_FALSE(EastMoneyProvider::parse_kline_row("2024-01-02,1,1,1").has_value());
+}
+
 // 错误处理测试
 TEST_F(ProvidersTest, ErrorHandling) {
     // 测试无效符号
@@ -205,7 +325,7 @@ TEST_F(ProvidersTest, EastMoneyProvider_DataFetching) {
         // 测试实时行情获取
         auto tick = provider.get_realtime_quote(symbol);
         if (tick.has_value()) {
-            EXPECT_FALSE(tick->symbol.empty());
+            EXPECT_FALSE(tick->symbol_name().empty());
             EXPECT_GT(tick->price, 0.0);
             std::cout << "  Price: " << tick->price << ", Volume: " << tick->volume << std::endl;
         } else {
@@ -248,7 +368,7 @@ TEST_F(ProvidersTest, SinaProvider_DataFetching) {
 
         auto tick = provider.get_realtime_quote(symbol);
         if (tick.has_value()) {
-            EXPECT_FALSE(tick->symbol.empty());
+            EXPECT_FALSE(tick->symbol_name().empty());
             EXPECT_GT(tick->price, 0.0);
             std::cout << "  Price: " << tick->price << ", Volume: " << tick->volume << std::endl;
         } else {
@@ -282,7 +402,7 @@ TEST_F(ProvidersTest, TencentProvider_DataFetching) {
 
         auto tick = provider.get_realtime_quote(symbol);
         if (tick.has_value()) {
-            EXPECT_FALSE(tick->symbol.empty());
+            EXPECT_FALSE(tick->symbol_name().empty());
             EXPECT_GT(tick->price, 0.0);
             std::cout << "  Price: " << tick->price << ", Volume: " << tick->volume << std::endl;
         } else {
@@ -316,7 +436,7 @@ TEST_F(ProvidersTest, NeteaseProvider_DataFetching) {
 
         auto tick = provider.get_realtime_quote(symbol);
         if (tick.has_value()) {
-            EXPECT_FALSE(tick->symbol.empty());
+            EXPECT_FALSE(tick->symbol_name().empty());
             EXPECT_GT(tick->price, 0.0);
             std::cout << "  Price: " << tick->price << ", Volume: " << tick->volume << std::endl;
         } else {
@@ -0,0 +1,188 @@
+#include "cppshares/utils/binary_log_segment.hpp"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "cppshares/utils/binary_log_reader.hpp"
+#include "cppshares/utils/logger.hpp"
+
+namespace cppshares::utils::tests {
+
+class BinaryLogSegmentTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() /
+               ("cppshares_segments_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(dir_);
+        base_path_ = (dir_ / "market_data.bin").string();
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir_); }
+
+    static MarketDataRecord make_record(uint32_t i) {
+        return {.symbol_id = i, .price = 10.0 + i, .volume = i, .side = 0, .padding = {0, 0, 0}};
+    }
+
+    uint64_t count_records(const std::vector<SegmentInfo>& segments) const {
+        uint64_t total = 0;
+        for (const auto& segment : segments) {
+            BinaryLogReader reader((dir_ / segment.file).string());
+            total += reader.get_statistics().market_data_records;
+        }
+        return total;
+    }
+
+    std::filesystem::path dir_;
+    std::string base_path_;
+};
+
+TEST_F(BinaryLogSegmentTest, RotatesBySizeAndWritesManifest) {
+    {
+        BinaryLogger logger(base_path_, TimestampSource::SYSTEM_CLOCK, {.max_segment_bytes = 4096});
+        for (uint32_t i = 0; i < 1000; ++i) {
+            logger.log_binary(make_record(i));
+        }
+    }
+
+    auto segments = BinaryLogSegments::read_manifest(base_path_);
+    ASSERT_GT(segments.size(), 5);
+    EXPECT_FALSE(std::filesystem::exists(base_path_));
+    for (const auto& segment : segments) {
+        EXPECT_EQ(segment.state, SegmentState::CLOSED);
+        EXPECT_EQ(segment.raw_bytes, std::filesystem::file_size(dir_ / segment.file));
+        EXPECT_LE(segment.raw_bytes, 4096 + 64 * 1024);
+    }
+    EXPECT_EQ(segments.front().file, "market_data.000001.bin");
+    EXPECT_EQ(count_records(segments), 1000);
+
+    // 重新打开时序号接续
+    { BinaryLogger logger(base_path_, TimestampSource::SYSTEM_CLOCK, {.max_segment_bytes = 4096}); }
+    auto reopened = BinaryLogSegments::read_manifest(base_path_);
+    ASSERT_EQ(reopened.size(), segments.size() + 1);
+    EXPECT_EQ(reopened.back().file, std::format("market_data.{:06d}.bin", segments.size() + 1));
+}
+
+TEST_F(BinaryLogSegmentTest, CompressesClosedSegmentsIntoSeekableBlocks) {
+    // 压缩块只在 CRC 校验块（每次落盘最多 64KB）的边界切分，分段需容纳多个校验块
+    SegmentConfig config{
+        .max_segment_bytes = 256 * 1024, .compress_closed = true, .block_size = 1024};
+    {
+        BinaryLogger logger(
+            base_path_, {.backpressure = BackpressurePolicy::BLOCK}, TimestampSource::TSC, config);
+        for (uint32_t i = 0; i < 20000; ++i) {
+            logger.log_binary(make_record(i));
+        }
+    }
+
+    auto segments = BinaryLogSegments::read_manifest(base_path_);
+    ASSERT_GT(segments.size(), 1);
+    for (const auto& segment : segments) {
+        EXPECT_EQ(segment.state, SegmentState::COMPRESSED);
+        EXPECT_TRUE(segment.file.ends_with(".binz"));
+        if (segment.raw_bytes > 4096) {
+            EXPECT_LT(std::filesystem::file_size(dir_ / segment.file), segment.raw_bytes);
+        }
+    }
+    // 读取端透明解压
+    EXPECT_EQ(count_records(segments), 20000);
+
+    // 按块访问：每块单独解压，带有块起点的时钟校准
+    CompressedLogReader compressed((dir_ / segments.front().file).string());
+    ASSERT_GT(compressed.block_count(), 1);
+    EXPECT_EQ(compressed.raw_size(), segments.front().raw_bytes);
+
+    size_t last_block = compressed.block_count() - 1;
+    TscCalibration clock;
+    auto raw = compressed.read_block(last_block, &clock);
+    EXPECT_GT(clock.ns_per_tick, 0.0);
+
+    BinaryLogIterator it(raw.data(), raw.data() + raw.size(), clock);
+    ASSERT_NE(it, BinaryLogIterator(raw.data() + raw.size(), raw.data() + raw.size()));
+    EXPECT_EQ((*it).unix_us, compressed.block(last_block).first_unix_us);
+
+    EXPECT_EQ(compressed.find_block_by_time(compressed.block(last_block).first_unix_us),
+              last_block);
+    EXPECT_EQ(compressed.find_block_by_offset(compressed.block(1).raw_offset + 1), 1);
+    EXPECT_EQ(compressed.find_block_by_time(0), 0);
+
+    // 按时间查询只解压涉及的块，结果与整体解压后的线性扫描一致
+    BinaryLogReader reader((dir_ / segments.front().file).string());
+    auto begin_us = compressed.block(1).first_unix_us;
+    auto end_us = begin_us + 1;
+    auto to_time = [](uint64_t unix_us) {
+        return std::chrono::system_clock::time_point(std::chrono::microseconds(unix_us));
+    };
+    auto queried = reader.records_between(to_time(begin_us), to_time(end_us));
+    EXPECT_FALSE(queried.empty());
+    EXPECT_LT(reader.decompressed_blocks(), compressed.block_count());
+
+    size_t expected = 0;
+    for (const auto& record : reader.records()) {
+        if (record.event_type() != ClockCalibrationRecord::TYPE_ID && record.unix_us >= begin_us &&
+            record.unix_us < end_us) {
+            expected++;
+        }
+    }
+    EXPECT_EQ(queried.size(), expected);
+}
+
+TEST_F(BinaryLogSegmentTest, CompressionKeepsCorruptAndTornBytes) {
+    std::filesystem::create_directories(dir_);
+    {
+        BinaryLogger logger(base_path_);
+        for (uint32_t i = 0; i < 5000; ++i) {
+            logger.log_binary(make_record(i));
+        }
+    }
+
+    // 中间写入垃圾，尾部追加半条记录，模拟崩溃后留下的分段
+    std::string original;
+    {
+        std::ifstream file(base_path_, std::ios::binary);
+        original.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    std::fill_n(original.begin() + static_cast<std::ptrdiff_t>(original.size() / 2), 64, '\xff');
+    original.append("torn-tail");
+    {
+        std::ofstream file(base_path_, std::ios::binary | std::ios::trunc);
+        file.write(original.data(), static_cast<std::streamsize>(original.size()));
+    }
+
+    auto destination = base_path_ + "z";
+    EXPECT_GT(compress_segment(base_path_, destination, 4096, 1), 1u);
+    CompressedLogReader reader(destination);
+    EXPECT_EQ(reader.raw_size(), original.size());
+    auto restored = reader.read_all();
+    EXPECT_EQ(std::string(restored.begin(), restored.end()), original);
+}
+
+// 恢复模式按 CRC 校验块读取，压缩块的切分不能把校验块截断
+TEST_F(BinaryLogSegmentTest, RecoverModeReadsEveryCompressedRecord) {
+    std::filesystem::create_directories(dir_);
+    constexpr uint32_t count = 20000;
+    {
+        BinaryLogger logger(base_path_);
+        for (uint32_t i = 0; i < count; ++i) {
+            logger.log_binary(make_record(i));
+        }
+    }
+
+    auto destination = base_path_ + "z";
+    EXPECT_GT(compress_segment(base_path_, destination, 4096, 1), 1u);
+
+    BinaryLogReader reader(destination, LogReadMode::RECOVER);
+    auto all = reader.records_between(std::chrono::system_clock::time_point{},
+                                      std::chrono::system_clock::time_point::max(),
+                                      MarketDataRecord::TYPE_ID);
+    EXPECT_EQ(all.size(), count);
+    EXPECT_EQ(reader.get_statistics().market_data_records, count);
+    EXPECT_EQ(reader.get_statistics().skipped_bytes, 0);
+}
+
+}  // namespace cppshares::utils::tests
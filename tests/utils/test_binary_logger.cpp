@@ -0,0 +1,559 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <ranges>
+#include <sstream>
+#include <string_view>
+#include <thread>
+
+#include "cppshares/utils/binary_log_reader.hpp"
+#include "cppshares/utils/logger.hpp"
+
+namespace cppshares::utils::tests {
+
+class BinaryLoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("cppshares_binary_" + std::to_string(::getpid()) + ".bin"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+        std::filesystem::remove(BinaryLogTimeIndex::sidecar_path(path_));
+    }
+
+    static MarketDataRecord make_record(uint32_t i) {
+        return {.symbol_id = i, .price = 10.0 + i, .volume = i, .side = 0, .padding = {0, 0, 0}};
+    }
+
+    size_t record_count() const {
+        BinaryLogReader reader(path_);
+        return reader.get_statistics().market_data_records;
+    }
+
+    std::string path_;
+};
+
+TEST_F(BinaryLoggerTest, AsyncWritesEveryRecordWhenBlocking) {
+    constexpr int thread_count = 4;
+    constexpr int per_thread = 20000;
+
+    {
+        BinaryLogger logger(path_, {.ring_capacity = 1024, .backpressure = BackpressurePolicy::BLOCK});
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < per_thread; ++i) {
+                    logger.log_binary(make_record(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        logger.flush();
+        EXPECT_EQ(record_count(), thread_count * per_thread);
+        EXPECT_EQ(logger.get_statistics().dropped, 0);
+    }
+}
+
+// 超过环形缓冲区槽位的记录在异步模式下走持锁写入，与队列中的记录保持先后顺序
+struct LargeRecord {
+    static constexpr uint32_t TYPE_ID = 0x7001;
+    char data[64];
+};
+
+TEST_F(BinaryLoggerTest, AsyncWritesOversizedRecordsInOrder) {
+    {
+        BinaryLogger logger(path_, {.backpressure = BackpressurePolicy::BLOCK});
+        LargeRecord large{};
+        for (uint32_t i = 0; i < 100; ++i) {
+            logger.log_binary(make_record(i));
+            large.data[0] = static_cast<char>(i);
+            logger.log_binary(large);
+        }
+        logger.flush();
+    }
+
+    BinaryLogReader reader(path_);
+    std::vector<uint32_t> types;
+    for (const auto& record : reader.records()) {
+        if (record.event_type() != ClockCalibrationRecord::TYPE_ID) {
+            types.push_back(record.event_type());
+        }
+    }
+    ASSERT_EQ(types.size(), 200u);
+    for (size_t i = 0; i < types.size(); ++i) {
+        EXPECT_EQ(types[i], i % 2 == 0 ? MarketDataRecord::TYPE_ID : LargeRecord::TYPE_ID);
+    }
+}
+
+TEST_F(BinaryLoggerTest, AsyncDropPolicyCountsDrops) {
+    size_t dropped = 0;
+    {
+        // 刷盘线程休眠较长，小缓冲区必然写满
+        BinaryLogger logger(path_,
+                            {.ring_capacity = 16,
+                             .backpressure = BackpressurePolicy::DROP,
+                             .idle_sleep = std::chrono::milliseconds(50)});
+        for (uint32_t i = 0; i < 1000; ++i) {
+            logger.log_binary(make_record(i));
+        }
+        dropped = logger.get_statistics().dropped;
+        EXPECT_GT(dropped, 0);
+    }
+    EXPECT_EQ(record_count() + dropped, 1000);
+}
+
+// 基准：多线程写入时同步（持锁）路径与异步（无锁环形缓冲区）路径的单条记录耗时
+TEST_F(BinaryLoggerTest, AsyncVersusMutexBenchmark) {
+    constexpr int thread_count = 4;
+    constexpr int per_thread = 100000;
+
+    auto run = [&](BinaryLogger& logger) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < per_thread; ++i) {
+                    logger.log_binary(make_record(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() /
+               (thread_count * per_thread);
+    };
+
+    double mutex_ns = 0;
+    {
+        BinaryLogger logger(path_);
+        mutex_ns = run(logger);
+    }
+    std::filesystem::remove(path_);
+
+    double async_ns = 0;
+    {
+        BinaryLogger logger(path_, {.backpressure = BackpressurePolicy::BLOCK});
+        async_ns = run(logger);
+        logger.flush();
+    }
+    EXPECT_EQ(record_count(), thread_count * per_thread);
+
+    std::cout << "BinaryLogger per record (" << thread_count << " threads): mutex " << mutex_ns
+              << " ns, async " << async_ns << " ns" << std::endl;
+}
+
+TEST_F(BinaryLoggerTest, TscTimestampsDecodeToWallClock) {
+    auto before = std::chrono::system_clock::now();
+    {
+        BinaryLogger logger(path_, TimestampSource::TSC);
+        logger.log_binary(make_record(1));
+        logger.log_binary(make_record(2));
+    }
+    auto after = std::chrono::system_clock::now();
+
+    // 追加一段旧格式（system_clock 微秒）的会话，读取端应按新的校准记录切换解释方式
+    {
+        BinaryLogger logger(path_);
+        logger.log_binary(make_record(3));
+    }
+
+    BinaryLogReader reader(path_);
+    auto stats = reader.get_statistics();
+    EXPECT_EQ(stats.market_data_records, 3);
+    EXPECT_EQ(stats.calibration_records, 2);
+
+    // 允许校准误差
+    auto tolerance = std::chrono::milliseconds(50);
+    EXPECT_GE(stats.first_timestamp, before - tolerance);
+    EXPECT_LE(stats.first_timestamp, after + tolerance);
+    EXPECT_GE(stats.last_timestamp, stats.first_timestamp);
+    EXPECT_LE(stats.last_timestamp, std::chrono::system_clock::now() + tolerance);
+}
+
+TEST_F(BinaryLoggerTest, MappedRecordsIterateWithRanges) {
+    {
+        BinaryLogger logger(path_);
+        for (uint32_t i = 0; i < 100; ++i) {
+            logger.log_binary(make_record(i));
+            if (i % 10 == 0) {
+                logger.log_binary(OrderRecord{.order_id = i,
+                                              .symbol_id = i,
+                                              .price = 1.0,
+                                              .quantity = 100,
+                                              .side = 0,
+                                              .status = 0,
+                                              .padding = {0, 0}});
+            }
+        }
+    }
+
+    BinaryLogReader reader(path_);
+    auto is_market = [](const BinaryLogRecord& record) {
+        return record.event_type() == MarketDataRecord::TYPE_ID;
+    };
+    EXPECT_EQ(std::ranges::count_if(reader.records(), is_market), 100);
+
+    // 零拷贝视图按原始顺序解码
+    uint32_t expected = 0;
+    for (const auto& record : reader.records() | std::views::filter(is_market)) {
+        auto market = record.as<MarketDataRecord>();
+        ASSERT_TRUE(market.has_value());
+        EXPECT_EQ(market->symbol_id, expected);
+        EXPECT_DOUBLE_EQ(market->price, 10.0 + expected);
+        expected++;
+    }
+
+    auto stats = reader.get_statistics();
+    EXPECT_EQ(stats.market_data_records, 100);
+    EXPECT_EQ(stats.order_records, 10);
+    EXPECT_EQ(stats.calibration_records, 1);
+}
+
+TEST_F(BinaryLoggerTest, MappedReaderStopsAtTruncatedTail) {
+    {
+        BinaryLogger logger(path_);
+        for (uint32_t i = 0; i < 10; ++i) {
+            logger.log_binary(make_record(i));
+        }
+    }
+
+    // 模拟写入中断：头部完整但数据部分缺失的尾部记录
+    {
+        std::ofstream file(path_, std::ios::binary | std::ios::app);
+        BinaryLogEntry header{
+            .timestamp_us = 0, .event_type = MarketDataRecord::TYPE_ID, .data_size = 1024};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write("partial", 7);
+    }
+
+    BinaryLogReader reader(path_);
+    EXPECT_EQ(std::ranges::distance(reader.records()), 11);  // 含一条校准记录
+    EXPECT_EQ(reader.get_statistics().market_data_records, 10);
+}
+
+TEST(Crc32cTest, MatchesReferenceValues) {
+    std::string_view check = "123456789";
+    EXPECT_EQ(crc32c(check.data(), check.size()), 0xE3069283u);
+
+    // 分段计算与整体计算一致，覆盖 8 字节对齐之外的尾部
+    std::vector<char> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 31);
+    }
+    auto whole = crc32c(data.data(), data.size());
+    EXPECT_EQ(crc32c(data.data() + 333, data.size() - 333, crc32c(data.data(), 333)), whole);
+}
+
+TEST_F(BinaryLoggerTest, RecoverModeResyncsAfterCorruptBlock) {
+    {
+        BinaryLogger logger(path_);
+        for (uint32_t i = 0; i < 500; ++i) {
+            logger.log_binary(make_record(i));
+            if (i % 50 == 49) {
+                logger.flush();  // 每 50 条记录一个块
+            }
+        }
+    }
+
+    std::vector<char> bytes;
+    {
+        std::ifstream file(path_, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    std::vector<size_t> block_starts;  // 各块第一条记录的偏移
+    std::string_view view(bytes.data(), bytes.size());
+    std::string_view magic(BINARY_LOG_BLOCK_MAGIC, sizeof(BINARY_LOG_BLOCK_MAGIC));
+    for (auto found = view.find(magic); found != std::string_view::npos;
+         found = view.find(magic, found + 1)) {
+        block_starts.push_back(found + sizeof(BlockMarkerRecord));
+    }
+    ASSERT_EQ(block_starts.size(), 10u);
+
+    // 第 4 块第一条记录的长度字段损坏，再追加一个写了一半的块
+    uint32_t bad_size = 0xFFFF;
+    std::memcpy(bytes.data() + block_starts[3] + offsetof(BinaryLogEntry, data_size),
+                &bad_size,
+                sizeof(bad_size));
+    std::vector<char> torn(bytes.begin() + static_cast<std::ptrdiff_t>(block_starts[1]) -
+                               sizeof(BinaryLogEntry) - sizeof(BlockMarkerRecord),
+                           bytes.begin() + static_cast<std::ptrdiff_t>(block_starts[1]) + 200);
+    bytes.insert(bytes.end(), torn.begin(), torn.end());
+    {
+        std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    EXPECT_EQ(record_count(), 150u);  // FAST 模式在损坏处停止
+
+    BinaryLogReader reader(path_, LogReadMode::RECOVER);
+    auto stats = reader.get_statistics();
+    EXPECT_EQ(stats.market_data_records, 450u);
+    EXPECT_EQ(stats.resyncs, 2u);
+    EXPECT_GT(stats.skipped_bytes, 0u);
+
+    std::vector<uint32_t> symbols;
+    for (const auto& record : reader.records()) {
+        if (record.event_type() == MarketDataRecord::TYPE_ID) {
+            symbols.push_back(record.as<MarketDataRecord>()->symbol_id);
+        }
+    }
+    ASSERT_EQ(symbols.size(), 450u);
+    EXPECT_EQ(symbols[149], 149u);
+    EXPECT_EQ(symbols[150], 200u);  // 跳过整个损坏的块
+    EXPECT_EQ(symbols.back(), 499u);
+}
+
+TEST_F(BinaryLoggerTest, TimeIndexQueryMatchesLinearScan) {
+    auto write_session = [&](uint32_t first) {
+        BinaryLogger logger(path_);
+        for (uint32_t i = first; i < first + 300; ++i) {
+            logger.log_binary(make_record(i));
+            if (i % 3 == 0) {
+                logger.log_binary(OrderRecord{.order_id = i,
+                                              .symbol_id = i,
+                                              .price = 1.0,
+                                              .quantity = 100,
+                                              .side = 0,
+                                              .status = 0,
+                                              .padding = {0, 0}});
+            }
+            if (i % 100 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(3));
+            }
+        }
+    };
+    write_session(0);
+
+    using TimePoint = std::chrono::system_clock::time_point;
+    auto to_time = [](uint64_t us) { return TimePoint(std::chrono::microseconds(us)); };
+
+    // 以线性扫描结果作为基准
+    auto linear = [&](BinaryLogReader& reader,
+                      uint64_t begin_us,
+                      uint64_t end_us,
+                      std::optional<uint32_t> type) {
+        std::vector<const BinaryLogEntry*> result;
+        for (const auto& record : reader.records()) {
+            if (record.event_type() != ClockCalibrationRecord::TYPE_ID &&
+                (!type || record.event_type() == *type) && record.unix_us >= begin_us &&
+                record.unix_us < end_us) {
+                result.push_back(record.header);
+            }
+        }
+        return result;
+    };
+    auto indexed = [&](BinaryLogReader& reader,
+                       uint64_t begin_us,
+                       uint64_t end_us,
+                       std::optional<uint32_t> type) {
+        std::vector<const BinaryLogEntry*> result;
+        auto records = reader.records_between(to_time(begin_us), to_time(end_us), type);
+        for (const auto& record : records) {
+            result.push_back(record.header);
+        }
+        return result;
+    };
+
+    {
+        BinaryLogReader reader(path_);
+        reader.build_time_index(std::chrono::milliseconds(1));
+
+        std::vector<uint64_t> timestamps;
+        for (const auto& record : reader.records()) {
+            if (record.event_type() != ClockCalibrationRecord::TYPE_ID) {
+                timestamps.push_back(record.unix_us);
+            }
+        }
+        ASSERT_GT(timestamps.size(), 300);
+
+        auto begin_us = timestamps[100];
+        auto end_us = timestamps[250];
+        EXPECT_EQ(indexed(reader, begin_us, end_us, std::nullopt),
+                  linear(reader, begin_us, end_us, std::nullopt));
+        EXPECT_EQ(indexed(reader, begin_us, end_us, OrderRecord::TYPE_ID),
+                  linear(reader, begin_us, end_us, OrderRecord::TYPE_ID));
+        EXPECT_FALSE(indexed(reader, begin_us, end_us, std::nullopt).empty());
+        EXPECT_TRUE(indexed(reader, end_us, begin_us, std::nullopt).empty());
+    }
+    EXPECT_TRUE(std::filesystem::exists(BinaryLogTimeIndex::sidecar_path(path_)));
+
+    // 追加新会话后，已有索引被加载并只为新增部分补充索引
+    write_session(300);
+    BinaryLogReader reader(path_);
+    const auto& index = reader.time_index();
+    EXPECT_EQ(index.bucket_us(), 1000);
+    EXPECT_EQ(index.indexed_size(), std::filesystem::file_size(path_));
+    EXPECT_EQ(indexed(reader, 0, UINT64_MAX, MarketDataRecord::TYPE_ID).size(), 600);
+}
+
+TEST_F(BinaryLoggerTest, TimeIndexRebuildsForReplacedLog) {
+    auto write_log = [&](uint32_t count, bool with_orders) {
+        std::filesystem::remove(path_);
+        BinaryLogger logger(path_);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (with_orders) {
+                logger.log_binary(OrderRecord{.order_id = i,
+                                              .symbol_id = i,
+                                              .price = 1.0,
+                                              .quantity = 100,
+                                              .side = 0,
+                                              .status = 0,
+                                              .padding = {0, 0}});
+            }
+            logger.log_binary(make_record(i));
+            if (i % 100 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    };
+    // 从文件中第一条记录的时间开始查询，旧索引中更早的时间桶不在范围内
+    auto query_all = [&](BinaryLogReader& reader) {
+        auto first_us = (*reader.records().begin()).unix_us;
+        std::vector<uint32_t> symbols;
+        for (const auto& record : reader.records_between(
+                 std::chrono::system_clock::time_point(std::chrono::microseconds(first_us)),
+                 std::chrono::system_clock::time_point::max(),
+                 MarketDataRecord::TYPE_ID)) {
+            symbols.push_back(record.as<MarketDataRecord>()->symbol_id);
+        }
+        return symbols;
+    };
+
+    write_log(300, false);
+    {
+        BinaryLogReader reader(path_);
+        reader.build_time_index(std::chrono::milliseconds(1));
+        EXPECT_EQ(query_all(reader).size(), 300);
+    }
+    ASSERT_TRUE(std::filesystem::exists(BinaryLogTimeIndex::sidecar_path(path_)));
+
+    // 日志被替换为更大、记录布局不同的新文件，旧索引的偏移不再对应记录边界，应重建
+    write_log(700, true);
+    BinaryLogReader reader(path_);
+    auto symbols = query_all(reader);
+    ASSERT_EQ(symbols.size(), 700);
+    for (uint32_t i = 0; i < symbols.size(); ++i) {
+        EXPECT_EQ(symbols[i], i);
+    }
+}
+
+TEST_F(BinaryLoggerTest, ParallelCsvExportMatchesSequential) {
+    {
+        BinaryLogger logger(path_);
+        for (uint32_t i = 0; i < 20000; ++i) {
+            logger.log_binary(make_record(i % 50));
+        }
+    }
+
+    SymbolRegistry::global().intern("600000.SH.STOCK");
+    auto csv_path = path_ + ".csv";
+    auto export_with = [&](CsvExportConfig config) {
+        BinaryLogReader reader(path_);
+        reader.set_csv_export_config(config);
+
+        auto start = std::chrono::steady_clock::now();
+        reader.export_market_data_to_csv(csv_path);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        std::ifstream file(csv_path);
+        std::stringstream content;
+        content << file.rdbuf();
+        std::filesystem::remove(csv_path);
+        return std::pair(content.str(), std::chrono::duration<double, std::milli>(elapsed).count());
+    };
+
+    auto [sequential, sequential_ms] = export_with({.threads = 1});
+    auto [parallel, parallel_ms] = export_with({.threads = 4, .chunk_bytes = 4096});
+    EXPECT_EQ(parallel, sequential);
+    EXPECT_EQ(std::ranges::count(sequential, '\n'), 20001);
+
+    // 时间戳格式与 chrono 格式化一致
+    BinaryLogReader reader(path_);
+    auto first = *std::ranges::find_if(reader.records(), [](const BinaryLogRecord& record) {
+        return record.event_type() == MarketDataRecord::TYPE_ID;
+    });
+    auto time_point = std::chrono::sys_seconds(std::chrono::seconds(first.unix_us / 1000000));
+    const auto& symbol = SymbolRegistry::global().name(0);
+    auto expected = std::format("{:%Y-%m-%d %H:%M:%S}.{:06d},{},10.000000,0,BUY",
+                                time_point,
+                                first.unix_us % 1000000,
+                                symbol.empty() ? "UNKNOWN" : symbol);
+    auto second_line = sequential.substr(sequential.find('\n') + 1);
+    EXPECT_EQ(second_line.substr(0, second_line.find('\n')), expected);
+
+    std::cout << "CSV export of 20000 records: 1 thread " << sequential_ms << " ms, 4 threads "
+              << parallel_ms << " ms" << std::endl;
+}
+
+TEST_F(BinaryLoggerTest, FixedMarketDataReadsAsMarketData) {
+    {
+        BinaryLogger logger(path_);
+        logger.log_binary(make_record(1));
+        logger.log_binary(FixedMarketDataRecord{.symbol_id = 2,
+                                                .price = static_cast<int32_t>(
+                                                    Price::from_double(12.34).raw()),
+                                                .volume = 300,
+                                                .side = 1,
+                                                .padding = {0, 0, 0}});
+    }
+
+    BinaryLogReader reader(path_);
+    EXPECT_EQ(reader.get_statistics().market_data_records, 2);
+
+    std::vector<MarketDataRecord> records;
+    for (const auto& record : reader.records()) {
+        if (auto market = record.market_data()) {
+            records.push_back(*market);
+        }
+    }
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_DOUBLE_EQ(records[0].price, 11.0);
+    EXPECT_EQ(records[1].symbol_id, 2u);
+    EXPECT_DOUBLE_EQ(records[1].price, 12.34);
+    EXPECT_EQ(records[1].volume, 300u);
+    EXPECT_EQ(records[1].side, 1);
+
+    // 两种格式导出为同样的 CSV 行
+    auto csv_path = path_ + ".csv";
+    reader.export_market_data_to_csv(csv_path);
+    std::ifstream file(csv_path);
+    std::stringstream content;
+    content << file.rdbuf();
+    std::filesystem::remove(csv_path);
+    EXPECT_EQ(std::ranges::count(content.str(), '\n'), 3);
+    EXPECT_NE(content.str().find(",12.340000,300,SELL\n"), std::string::npos);
+
+    // 按行情类型查询同样匹配两种格式，压缩分段与原始文件一致
+    auto all_time = [](BinaryLogReader& log, uint32_t type) {
+        return log.records_between(std::chrono::system_clock::time_point{},
+                                   std::chrono::system_clock::time_point::max(),
+                                   type);
+    };
+    EXPECT_EQ(all_time(reader, MarketDataRecord::TYPE_ID).size(), 2u);
+    EXPECT_EQ(all_time(reader, FixedMarketDataRecord::TYPE_ID).size(), 1u);
+
+    auto compressed_path = path_ + "z";
+    compress_segment(path_, compressed_path, 4096, 1);
+    {
+        BinaryLogReader compressed(compressed_path);
+        EXPECT_EQ(all_time(compressed, MarketDataRecord::TYPE_ID).size(), 2u);
+        EXPECT_EQ(all_time(compressed, FixedMarketDataRecord::TYPE_ID).size(), 1u);
+    }
+    std::filesystem::remove(compressed_path);
+}
+
+}  // namespace cppshares::utils::tests
@@ -0,0 +1,102 @@
+#include "cppshares/utils/columnar_log.hpp"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+
+#include "cppshares/utils/logger.hpp"
+
+namespace cppshares::utils::tests {
+
+class ColumnarLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() /
+               ("cppshares_columnar_" + std::to_string(::getpid()));
+        std::filesystem::create_directories(dir_);
+        log_path_ = (dir_ / "market_data.bin").string();
+
+        BinaryLogger logger(log_path_, TimestampSource::TSC);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            logger.log_binary(MarketDataRecord{.symbol_id = i % 7,
+                                               .price = 10.0 + i * 0.01,
+                                               .volume = i * 100,
+                                               .side = static_cast<uint8_t>(i % 2),
+                                               .padding = {0, 0, 0}});
+            if (i % 10 == 0) {
+                logger.log_binary(OrderRecord{.order_id = i,
+                                              .symbol_id = i % 7,
+                                              .price = 10.0,
+                                              .quantity = 200,
+                                              .side = 1,
+                                              .status = 2,
+                                              .padding = {0, 0}});
+            }
+        }
+        logger.log_binary(StrategySignalRecord{.strategy_id = 3,
+                                               .symbol_id = 5,
+                                               .signal_type = 2,
+                                               .confidence = 80,
+                                               .target_price = 12.5,
+                                               .target_quantity = 300,
+                                               .padding = {0, 0}});
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir_); }
+
+    std::filesystem::path dir_;
+    std::string log_path_;
+};
+
+TEST_F(ColumnarLogTest, ExportsEveryRecordTypeAsColumns) {
+    BinaryLogReader reader(log_path_);
+    auto paths = ColumnarExporter().export_all(reader, (dir_ / "columns").string());
+    ASSERT_EQ(paths.size(), 3);
+
+    ColumnarFile market(paths[0]);
+    EXPECT_EQ(market.event_type(), MarketDataRecord::TYPE_ID);
+    ASSERT_EQ(market.row_count(), 1000);
+    auto symbols = market.column<uint32_t>("symbol_id");
+    auto prices = market.column<double>("price");
+    auto volumes = market.column<uint64_t>("volume");
+    auto sides = market.column<uint8_t>("side");
+    EXPECT_EQ(symbols[13], 13 % 7);
+    EXPECT_DOUBLE_EQ(prices[500], 15.0);
+    EXPECT_EQ(volumes[999], 99900);
+    EXPECT_EQ(sides[3], 1);
+    EXPECT_THROW(market.column<double>("volume"), std::runtime_error);
+
+    // DELTA 编码的时间戳还原后与二进制日志一致
+    std::vector<uint64_t> expected;
+    for (const auto& record : reader.records()) {
+        if (record.event_type() == MarketDataRecord::TYPE_ID) {
+            expected.push_back(record.unix_us);
+        }
+    }
+    EXPECT_EQ(market.find_column("timestamp_us")->encoding, ColumnEncoding::DELTA);
+    EXPECT_EQ(market.timestamps(), expected);
+
+    ColumnarFile orders(paths[1]);
+    ASSERT_EQ(orders.row_count(), 100);
+    EXPECT_EQ(orders.column<uint64_t>("order_id")[7], 70);
+    EXPECT_EQ(orders.column<uint8_t>("status")[0], 2);
+
+    ColumnarFile signals(paths[2]);
+    ASSERT_EQ(signals.row_count(), 1);
+    EXPECT_EQ(signals.column<uint32_t>("strategy_id")[0], 3);
+    EXPECT_DOUBLE_EQ(signals.column<double>("target_price")[0], 12.5);
+}
+
+TEST_F(ColumnarLogTest, PlainTimestampsAreDirectlyAddressable) {
+    BinaryLogReader reader(log_path_);
+    auto paths = ColumnarExporter({.delta_timestamps = false})
+                     .export_all(reader, (dir_ / "columns").string());
+
+    ColumnarFile market(paths[0]);
+    auto timestamps = market.column<uint64_t>("timestamp_us");
+    EXPECT_EQ(std::vector<uint64_t>(timestamps.begin(), timestamps.end()), market.timestamps());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(timestamps.data()) % COLUMN_ALIGNMENT, 0);
+}
+
+}  // namespace cppshares::utils::tests
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "cppshares/utils/price.hpp"
+
+namespace cppshares::utils::tests {
+
+TEST(PriceTest, ArithmeticIsExact) {
+    auto a = Price::from_double(0.1);
+    auto b = Price::from_double(0.2);
+    EXPECT_EQ(a + b, Price::from_double(0.3));
+    EXPECT_EQ((a + b).raw(), 3000);
+    EXPECT_EQ(b - a, a);
+    EXPECT_EQ(a * 3, 3 * a);
+    EXPECT_EQ((a * 3) / 3, a);
+    EXPECT_LT(-a, a);
+    EXPECT_DOUBLE_EQ(Price::from_raw(123456).to_double(), 12.3456);
+
+    auto total = Price();
+    for (int i = 0; i < 1000; ++i) {
+        total += Price::from_double(0.01);
+    }
+    EXPECT_EQ(total, Price::from_double(10.0));
+    total -= Price::from_double(10.0);
+    EXPECT_EQ(total, Price());
+}
+
+TEST(PriceTest, RoundsToTick) {
+    auto cent = Price::from_raw(100);
+    EXPECT_EQ(Price::from_double(10.125).round_to(cent), Price::from_double(10.13));
+    EXPECT_EQ(Price::from_double(10.1249).round_to(cent), Price::from_double(10.12));
+    EXPECT_EQ(Price::from_double(-10.125).round_to(cent), Price::from_double(-10.13));
+    EXPECT_EQ(Price::from_double(10.1249).round_to(Price()), Price::from_double(10.1249));
+}
+
+TEST(PriceTest, Formatting) {
+    auto price = Price::from_double(1234.5678);
+    EXPECT_EQ(price.to_string(), "1234.5678");
+    EXPECT_EQ(price.to_string(2), "1234.57");
+    EXPECT_EQ(price.to_string(0), "1235");
+    EXPECT_EQ(price.to_string(6), "1234.567800");
+    EXPECT_EQ(Price::from_double(0.05).to_string(3), "0.050");
+    EXPECT_EQ(Price::from_double(-0.005).to_string(2), "-0.01");
+    EXPECT_EQ(Price::from_raw(INT64_MIN).to_string(), "-922337203685477.5808");
+
+    std::string out = "price=";
+    Price::from_double(9.9).append_to(out, 2);
+    EXPECT_EQ(out, "price=9.90");
+}
+
+}  // namespace cppshares::utils::tests
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "cppshares/data/providers/eastmoney_sax.hpp"
+#include "cppshares/utils/response_capture.hpp"
+
+namespace cppshares::utils::tests {
+
+class ResponseCaptureTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("cppshares_capture_" + std::to_string(::getpid()) + ".capture"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override { std::filesystem::remove(path_); }
+
+    std::string path_;
+};
+
+TEST_F(ResponseCaptureTest, RoundTripAndReplay) {
+    std::string kline_body =
+        R"({"data":{"klines":[)"
+        R"("2024-01-02,9.39,9.21,9.42,9.21,1158366,1075742252.45,2.24,-1.92,-0.18,0.60",)"
+        R"("2024-01-03,9.19,9.20,9.22,9.02,733610,669557219.26,2.17,-0.11,-0.01,0.38"]}})";
+    std::string large_body(4096, 'x');
+
+    {
+        ResponseCapture capture({.path = path_, .sample_rate = 1.0});
+        capture.capture("EastMoney", "kline", "SZ000001", kline_body);
+        capture.capture("EastMoney", "realtime", "SZ000002", large_body, true);
+        capture.flush();
+
+        auto stats = capture.get_statistics();
+        EXPECT_EQ(stats.captured, 2);
+        EXPECT_EQ(stats.dropped, 0);
+        // 重复内容应被压缩
+        EXPECT_LT(stats.bytes_written, large_body.size());
+    }
+
+    ResponseCaptureReader reader(path_);
+    auto first = reader.next();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->provider, "EastMoney");
+    EXPECT_EQ(first->operation, "kline");
+    EXPECT_EQ(first->symbol, "SZ000001");
+    EXPECT_EQ(first->body, kline_body);
+    EXPECT_FALSE(first->error);
+
+    auto second = reader.next();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->body, large_body);
+    EXPECT_TRUE(second->error);
+    EXPECT_FALSE(reader.next().has_value());
+
+    // 回放给解析器
+    ResponseCaptureReader replayer(path_);
+    size_t decoded = 0;
+    replayer.replay([&](const CapturedResponse& record) {
+        if (record.operation != "kline") {
+            return;
+        }
+        std::vector<data::OHLCV> klines;
+        size_t invalid_rows = 0;
+        if (data::providers::EastMoneySax::decode_klines(record.body, klines, invalid_rows) ==
+            data::providers::SaxDecodeStatus::OK) {
+            decoded += klines.size();
+        }
+    });
+    EXPECT_EQ(decoded, 2);
+}
+
+TEST_F(ResponseCaptureTest, SamplingAndTruncatedTail) {
+    {
+        ResponseCapture capture({.path = path_, .sample_rate = 0.0});
+        capture.capture("EastMoney", "kline", "SZ000001", "{}");
+        capture.capture("EastMoney", "kline", "SZ000001", "{\"bad\"", true);
+        capture.flush();
+
+        auto stats = capture.get_statistics();
+        EXPECT_EQ(stats.sampled_out, 1);
+        EXPECT_EQ(stats.captured, 1);
+    }
+
+    // 模拟写入中断：尾部只有半条记录
+    {
+        std::ofstream file(path_, std::ios::binary | std::ios::app);
+        file.write("\x10\x00\x00\x00\x01", 5);
+    }
+
+    ResponseCaptureReader reader(path_);
+    EXPECT_EQ(reader.replay([](const CapturedResponse&) {}), 1);
+}
+
+}  // namespace cppshares::utils::tests
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cppshares/utils/symbol_registry.hpp"
+
+namespace cppshares::utils::tests {
+
+TEST(SymbolRegistryTest, InternsToDenseIds) {
+    SymbolRegistry registry;
+    EXPECT_EQ(registry.intern("600000.SH.STOCK"), 0u);
+    EXPECT_EQ(registry.intern("000001.SZ.STOCK"), 1u);
+    EXPECT_EQ(registry.intern("600000.SH.STOCK"), 0u);
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_EQ(registry.name(1), "000001.SZ.STOCK");
+    EXPECT_EQ(registry.name(7), "");
+    EXPECT_FALSE(registry.find("AAPL.US.STOCK").has_value());
+
+    // 按给定 id 注册时跳过的位置留空，之后驻留的名称从新的上界继续分配
+    registry.assign(5000, "AAPL.US.STOCK");
+    EXPECT_EQ(registry.size(), 5001u);
+    EXPECT_EQ(registry.name(5000), "AAPL.US.STOCK");
+    EXPECT_EQ(registry.name(4000), "");
+    EXPECT_EQ(registry.intern("MSFT.US.STOCK"), 5001u);
+
+    registry.assign(0, "600000.SH.STOCK");
+    EXPECT_THROW(registry.assign(1, "600000.SH.STOCK"), std::runtime_error);
+    EXPECT_THROW(registry.assign(0, "600001.SH.STOCK"), std::runtime_error);
+}
+
+TEST(SymbolRegistryTest, SaveAndLoadRoundTrip) {
+    auto path = (std::filesystem::temp_directory_path() /
+                 ("cppshares_symbols_" + std::to_string(::getpid()) + ".csv"))
+                    .string();
+
+    SymbolRegistry writer;
+    writer.intern("600000.SH.STOCK");
+    writer.assign(10, "000001.SZ.STOCK");
+    ASSERT_TRUE(writer.save(path));
+
+    SymbolRegistry reader;
+    reader.load(path);
+    std::filesystem::remove(path);
+    EXPECT_EQ(reader.find("600000.SH.STOCK"), 0u);
+    EXPECT_EQ(reader.find("000001.SZ.STOCK"), 10u);
+    EXPECT_EQ(reader.size(), 11u);
+}
+
+TEST(SymbolRegistryTest, ConcurrentInternAgreesOnIds) {
+    SymbolRegistry registry;
+    constexpr int SYMBOLS = 10000;
+    std::vector<std::vector<SymbolId>> results(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < SYMBOLS; ++i) {
+                results[t].push_back(registry.intern(std::to_string(i) + ".SH.STOCK"));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(registry.size(), static_cast<size_t>(SYMBOLS));
+    for (const auto& ids : results) {
+        EXPECT_EQ(ids, results[0]);
+    }
+    for (int i = 0; i < SYMBOLS; ++i) {
+        EXPECT_EQ(registry.name(results[0][i]), std::to_string(i) + ".SH.STOCK");
+    }
+}
+
+}  // namespace cppshares::utils::tests